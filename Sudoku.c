@@ -0,0 +1,1452 @@
+#include <string.h>								//Manipulate strings and arrays of characters functions header file, like memcpy
+#include <stdlib.h>								//General functions header file, like malloc
+#include <time.h>								//Date and time functions header file, for timing the search (SudokuStats)
+#include <pthread.h>								//POSIX threads functions header file, for building tables once and for SudokuSolveSplit
+#include <stdatomic.h>								//Atomic operations header file, for sharing the search of one puzzle between several threads
+#include <limits.h>								//Limits of integer types header file, like INT_MAX
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>								//SSE4.2 and AVX2 intrinsics header file, for the vectorized kernels (x86 processors only)
+#define X86KERNELS
+#endif
+#include "Sudoku.h"								//The functions this library offers, status codes and options
+
+/*---Sudoku solver library, the solving engines of SudokuSolver (see Sudoku.h for the functions it offers, and SudokuSolver.c for the program built on it)
+     Note:  using rules of Sudoku at http://www.sudoku.name/rules/en
+---*/
+
+
+/*---Highlights of the solution method
+	1)  Solves the puzzle by chronological backtracking in one loop over an explicit stack (data type SearchStack), not by recursion.  Each level of guessing works on its own copy of the search state in the stack, so a dead end is undone simply by going back to the copy of the level before.  There is at most one level per empty cell, so the stack is a fixed 82 levels and the search never uses more memory however many backtracks it takes
+	2)  Keeps a bitmask of the digits already used in each row, column and 3x3 region, so checking a value against the rules of Sudoku costs only a few bit operations, and memory use is fixed (no growing list of dead end solutions)
+	3)  The puzzle grid is one contiguous block of 81 bytes (data type Board), with precomputed tables giving the row, column and region of each cell, the cells of each row/column/region, and the peers of each cell, so no memory is allocated per puzzle and a copy of the grid is a single memcpy
+	4)  Before guessing, and after every guess, values are deduced by constraint propagation (naked singles, hidden singles and locked candidates), so most easy and medium puzzles are solved without guessing at all
+	5)  When guessing, the empty cell with the fewest candidates is guessed first (most constrained cell), using candidate counts that are kept up to date as candidates are removed
+	6)  The candidates of all cells are computed, and the candidate counts of all cells are scanned for singles and for the most constrained cell, by vectorized kernels (SSE4.2 or AVX2, with a scalar fallback), chosen for each call for the processor (function SelectKernels)
+	7)  A second solving engine, selected with SUDOKUENGINEDLX, treats the puzzle as an exact cover problem (each cell, and each value in each row, column and region, covered exactly once) and solves it with Knuth's Dancing Links (Algorithm X, function SolveDLX) over a node arena built once and copied for each puzzle, so it allocates no memory
+	8)  No state is kept between calls except tables built once and never changed after (through pthread_once), so every function can be called from any number of threads at once
+	9)  Each search can be given budgets (nodes visited, wall clock time, memory of its state) and a cancel flag, checked at every node of the search (function OutOfBudget), so a pathological puzzle is aborted with the counters of the search so far instead of running unbounded.  The memory of the search is already bounded (the fixed stack of the search, of which only the levels reached are used), the budget only bounds the levels reached lower
+---*/
+
+
+/*---Summary of key operations and functions used
+	1)  In function SudokuSolve, the key values of the puzzle are checked against the rules of Sudoku via the function ValidateBoard, and recorded in the search state (function InitState), which keeps the values still possible (candidates) for each empty cell, then the puzzle is solved by calling function AnalyzeCell
+	2)  In function AnalyzeCell, the function Propagate fills in every value that can be deduced: a cell with only one candidate (naked single), a value with only one possible cell in a row, column or region (hidden single), and candidates removed because a value in a region is locked to one row or column, or the other way around (locked candidates, function LockedCandidates).  Each value is placed via the function Change, which removes it from the candidates of the peers of the cell
+	3)  When nothing more can be deduced, AnalyzeCell picks the empty cell with the fewest candidates (function SelectCell) and tries each of its candidates on a copy of the search state pushed on the stack of the search.  If a copy reaches a dead end (a cell with no candidates, or a value with no possible cell), the next candidate is tried, and if no candidate works, the level is popped so that the previous level tries its next candidate
+---*/
+   
+   
+   
+   
+   
+
+/*---Declaration of data types
+	Board:		The puzzle grid, 81 cells in one contiguous block in row-major order (cell = row*9 + col), each cell is 0 for an empty (playable) cell or a value 1-9.  Boards live on the stack and are copied with memcpy (or plain assignment)
+	Masks:		Bitmask of the digits already placed in each row, column and region of a Board (bit val-1 is set if val is placed)
+	CellScan:	Result of scanning the candidate counts of all cells (kernel ScanCells), as bitmasks of cells, bit cell%32 of word cell/32
+	Kernels:	The kernels used by one search, scalar or vectorized (function SelectKernels)
+	Budget:		Limits of one search (nodes, time, depth allowed by the memory budget, cancel flag) and the nodes visited so far, shared by every copy of the search state and by every thread of SudokuSolveSplit
+	SearchState:	State of the search for a solution, the Board and Masks plus the candidates of each empty cell.  Each level of the search works on its own copy
+	SearchStack:	Explicit stack of the search of function CountCell, the copy of the search state at each level of guessing and the cell guessed there (trail), allocated once for the whole search
+	DLX:		Exact cover matrix of a puzzle for the Dancing Links engine, a fixed arena of nodes linked by index in 4 directions.  Each of the 729 rows is one value in one cell, with one node in each of its 4 columns (the cell, and the value in the row, in the column and in the region of the cell)
+	SplitSearch:	Search of one puzzle split into subtrees (tasks), shared by several worker threads (function SudokuSolveSplit)
+	SplitThread:	State of one worker thread searching subtrees of a SplitSearch
+---*/
+typedef struct Board
+{
+	unsigned char cell[81];								//Value of each cell, row-major, 0 for an empty cell
+} Board;
+
+typedef struct Masks
+{
+	unsigned short row[9], col[9], reg[9];						//Bitmask of the digits placed in each row, column and region
+} Masks;
+
+typedef struct CellScan
+{
+	unsigned int low[3];								//Empty cells with 0 or 1 candidates (dead ends and naked singles)
+	unsigned int best[3];								//Empty cells with the fewest candidates
+	int fewest;									//Fewest candidates of any empty cell, CELLFILLED if no cell is empty (best is then meaningless)
+} CellScan;
+
+struct SearchState;
+
+typedef struct Budget
+{
+	atomic_long nodes;								//Nodes of the search tree visited so far, by every thread of the search
+	long maxnodes;									//Most nodes visited, 0 for no limit
+	double deadline;								//Wall clock time the search is aborted at, 0 for no limit
+	int maxdepth;									//Deepest level of guessing the memory budget allows, -1 if not even the first level fits
+	const int *cancel;								//Cancel flag of the caller, NULL for none
+	atomic_int stop;								//Set to 1 to stop the search on every thread, when the budget runs out or the search is cancelled, or in SudokuSolveSplit when a solution is found
+	atomic_int aborted;								//Set to 1 if the search was stopped by the budget or the cancel flag
+} Budget;
+
+#define BUDGETCLOCK 256									//The wall clock is read once every BUDGETCLOCK nodes, so timing costs nothing measurable
+
+typedef struct Kernels
+{
+	void (*ScanCells)( const unsigned char *ncand, CellScan *scan );		//Finds the empty cells with 0 or 1 candidates and the empty cells with the fewest candidates
+	void (*ComputeCandidates)( struct SearchState *state );			//Computes the candidates and candidate count of every cell
+} Kernels;
+
+typedef struct SearchState
+{
+	Board board;									//Values of the cells, 0 for an empty cell
+	Masks masks;									//Bitmasks of the digits placed in each row, column and region
+	unsigned short cand[81];							//Bitmask of the values still possible in each empty cell (candidates), 0 for a filled cell
+	unsigned char ncand[96];							//Number of candidates of each empty cell, kept up to date with cand, CELLFILLED for a filled cell and for the padding after cell 80 (so the kernels can load 16 or 32 counts at a time)
+	int numempty;									//Number of empty cells left
+	int depth;									//Level of guessing of this copy of the state, 0 before the first guess
+	const Kernels *kernels;								//Kernels of the search
+	SudokuStats *stats;								//Counters of the search, shared by every copy of the state, NULL if not counted
+	Budget *budget;									//Limits of the search, shared by every copy of the state, NULL if none
+} SearchState;
+
+#define CELLFILLED 0xFF
+
+#define SEARCHLEVELS 82									//Levels of the search stack:  the state searched from (level 0), and at most one level per guess, each guess filling one of at most 81 empty cells
+
+typedef struct SearchStack
+{
+	SearchState level[SEARCHLEVELS];						//State of each level of guessing, level[0] is a copy of the state the search starts from
+	unsigned short cands[SEARCHLEVELS];						//Candidates of the cell guessed at each level, not tried yet
+	unsigned char cell[SEARCHLEVELS];						//Cell guessed at each level
+	int count[SEARCHLEVELS];							//Solutions found before the candidate being tried at each level, to tell a guess that led to a dead end
+} SearchStack;
+
+#define DLXCOLUMNS 324
+#define DLXROOT 0
+#define DLXFIRSTNODE (DLXCOLUMNS+1)
+#define DLXNODES (DLXFIRSTNODE + 729*4)
+
+typedef struct DLX
+{
+	unsigned short left[DLXNODES], right[DLXNODES], up[DLXNODES], down[DLXNODES];	//Links of each node, node 0 is the root, nodes 1-324 are the column headers, and the 4 nodes of row r (value r%9+1 in cell r/9) start at DLXFIRSTNODE + r*4
+	unsigned short column[DLXNODES];						//Column header of each node
+	unsigned short size[DLXFIRSTNODE];						//Number of nodes left in each column
+	unsigned short solution[81];							//Row chosen at each level of the search
+	SudokuStats *stats;								//Counters of the search, NULL if not counted
+	Budget *budget;									//Limits of the search, NULL if none
+} DLX;
+
+typedef struct SplitSearch
+{
+	SearchState *tasks;								//Search state at the root of each subtree
+	long numtasks;									//Number of subtrees
+	atomic_long nexttask;								//Index of the next subtree to be searched
+	atomic_int found;								//Set to 1 by the first thread to find a solution, which then stops the search on the other threads (budget stop)
+	Budget budget;									//Limits of the search, shared by all worker threads
+	Board solution;									//The solution found
+} SplitSearch;
+
+typedef struct SplitThread
+{
+	pthread_t thread;								//The worker thread
+	SplitSearch *search;								//Search shared by all worker threads
+} SplitThread;
+
+
+
+/*---Precomputed index tables for the 81 cells of a Board
+	cellrow, cellcol, cellreg:	Row, column and region (0-8, row-major) of each cell
+	units:		Cells of each row (units 0-8), column (units 9-17) and region (units 18-26)
+	peers:		The 20 other cells in the same row, column or region as each cell
+---*/
+static const unsigned char cellrow[81] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8, 8};
+static const unsigned char cellcol[81] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 1, 2, 3, 4, 5, 6, 7, 8};
+static const unsigned char cellreg[81] = { 0, 0, 0, 1, 1, 1, 2, 2, 2, 0, 0, 0, 1, 1, 1, 2, 2, 2, 0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 5, 3, 3, 3, 4, 4, 4, 5, 5, 5, 3, 3, 3, 4, 4, 4, 5, 5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 6, 6, 6, 7, 7, 7, 8, 8, 8, 6, 6, 6, 7, 7, 7, 8, 8, 8};
+static const unsigned char units[27][9] =
+{
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8},
+	{ 9,10,11,12,13,14,15,16,17},
+	{18,19,20,21,22,23,24,25,26},
+	{27,28,29,30,31,32,33,34,35},
+	{36,37,38,39,40,41,42,43,44},
+	{45,46,47,48,49,50,51,52,53},
+	{54,55,56,57,58,59,60,61,62},
+	{63,64,65,66,67,68,69,70,71},
+	{72,73,74,75,76,77,78,79,80},
+	{ 0, 9,18,27,36,45,54,63,72},
+	{ 1,10,19,28,37,46,55,64,73},
+	{ 2,11,20,29,38,47,56,65,74},
+	{ 3,12,21,30,39,48,57,66,75},
+	{ 4,13,22,31,40,49,58,67,76},
+	{ 5,14,23,32,41,50,59,68,77},
+	{ 6,15,24,33,42,51,60,69,78},
+	{ 7,16,25,34,43,52,61,70,79},
+	{ 8,17,26,35,44,53,62,71,80},
+	{ 0, 1, 2, 9,10,11,18,19,20},
+	{ 3, 4, 5,12,13,14,21,22,23},
+	{ 6, 7, 8,15,16,17,24,25,26},
+	{27,28,29,36,37,38,45,46,47},
+	{30,31,32,39,40,41,48,49,50},
+	{33,34,35,42,43,44,51,52,53},
+	{54,55,56,63,64,65,72,73,74},
+	{57,58,59,66,67,68,75,76,77},
+	{60,61,62,69,70,71,78,79,80}
+};
+static const unsigned char peers[81][20] =
+{
+	{ 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,18,19,20,27,36,45,54,63,72},
+	{ 0, 2, 3, 4, 5, 6, 7, 8, 9,10,11,18,19,20,28,37,46,55,64,73},
+	{ 0, 1, 3, 4, 5, 6, 7, 8, 9,10,11,18,19,20,29,38,47,56,65,74},
+	{ 0, 1, 2, 4, 5, 6, 7, 8,12,13,14,21,22,23,30,39,48,57,66,75},
+	{ 0, 1, 2, 3, 5, 6, 7, 8,12,13,14,21,22,23,31,40,49,58,67,76},
+	{ 0, 1, 2, 3, 4, 6, 7, 8,12,13,14,21,22,23,32,41,50,59,68,77},
+	{ 0, 1, 2, 3, 4, 5, 7, 8,15,16,17,24,25,26,33,42,51,60,69,78},
+	{ 0, 1, 2, 3, 4, 5, 6, 8,15,16,17,24,25,26,34,43,52,61,70,79},
+	{ 0, 1, 2, 3, 4, 5, 6, 7,15,16,17,24,25,26,35,44,53,62,71,80},
+	{ 0, 1, 2,10,11,12,13,14,15,16,17,18,19,20,27,36,45,54,63,72},
+	{ 0, 1, 2, 9,11,12,13,14,15,16,17,18,19,20,28,37,46,55,64,73},
+	{ 0, 1, 2, 9,10,12,13,14,15,16,17,18,19,20,29,38,47,56,65,74},
+	{ 3, 4, 5, 9,10,11,13,14,15,16,17,21,22,23,30,39,48,57,66,75},
+	{ 3, 4, 5, 9,10,11,12,14,15,16,17,21,22,23,31,40,49,58,67,76},
+	{ 3, 4, 5, 9,10,11,12,13,15,16,17,21,22,23,32,41,50,59,68,77},
+	{ 6, 7, 8, 9,10,11,12,13,14,16,17,24,25,26,33,42,51,60,69,78},
+	{ 6, 7, 8, 9,10,11,12,13,14,15,17,24,25,26,34,43,52,61,70,79},
+	{ 6, 7, 8, 9,10,11,12,13,14,15,16,24,25,26,35,44,53,62,71,80},
+	{ 0, 1, 2, 9,10,11,19,20,21,22,23,24,25,26,27,36,45,54,63,72},
+	{ 0, 1, 2, 9,10,11,18,20,21,22,23,24,25,26,28,37,46,55,64,73},
+	{ 0, 1, 2, 9,10,11,18,19,21,22,23,24,25,26,29,38,47,56,65,74},
+	{ 3, 4, 5,12,13,14,18,19,20,22,23,24,25,26,30,39,48,57,66,75},
+	{ 3, 4, 5,12,13,14,18,19,20,21,23,24,25,26,31,40,49,58,67,76},
+	{ 3, 4, 5,12,13,14,18,19,20,21,22,24,25,26,32,41,50,59,68,77},
+	{ 6, 7, 8,15,16,17,18,19,20,21,22,23,25,26,33,42,51,60,69,78},
+	{ 6, 7, 8,15,16,17,18,19,20,21,22,23,24,26,34,43,52,61,70,79},
+	{ 6, 7, 8,15,16,17,18,19,20,21,22,23,24,25,35,44,53,62,71,80},
+	{ 0, 9,18,28,29,30,31,32,33,34,35,36,37,38,45,46,47,54,63,72},
+	{ 1,10,19,27,29,30,31,32,33,34,35,36,37,38,45,46,47,55,64,73},
+	{ 2,11,20,27,28,30,31,32,33,34,35,36,37,38,45,46,47,56,65,74},
+	{ 3,12,21,27,28,29,31,32,33,34,35,39,40,41,48,49,50,57,66,75},
+	{ 4,13,22,27,28,29,30,32,33,34,35,39,40,41,48,49,50,58,67,76},
+	{ 5,14,23,27,28,29,30,31,33,34,35,39,40,41,48,49,50,59,68,77},
+	{ 6,15,24,27,28,29,30,31,32,34,35,42,43,44,51,52,53,60,69,78},
+	{ 7,16,25,27,28,29,30,31,32,33,35,42,43,44,51,52,53,61,70,79},
+	{ 8,17,26,27,28,29,30,31,32,33,34,42,43,44,51,52,53,62,71,80},
+	{ 0, 9,18,27,28,29,37,38,39,40,41,42,43,44,45,46,47,54,63,72},
+	{ 1,10,19,27,28,29,36,38,39,40,41,42,43,44,45,46,47,55,64,73},
+	{ 2,11,20,27,28,29,36,37,39,40,41,42,43,44,45,46,47,56,65,74},
+	{ 3,12,21,30,31,32,36,37,38,40,41,42,43,44,48,49,50,57,66,75},
+	{ 4,13,22,30,31,32,36,37,38,39,41,42,43,44,48,49,50,58,67,76},
+	{ 5,14,23,30,31,32,36,37,38,39,40,42,43,44,48,49,50,59,68,77},
+	{ 6,15,24,33,34,35,36,37,38,39,40,41,43,44,51,52,53,60,69,78},
+	{ 7,16,25,33,34,35,36,37,38,39,40,41,42,44,51,52,53,61,70,79},
+	{ 8,17,26,33,34,35,36,37,38,39,40,41,42,43,51,52,53,62,71,80},
+	{ 0, 9,18,27,28,29,36,37,38,46,47,48,49,50,51,52,53,54,63,72},
+	{ 1,10,19,27,28,29,36,37,38,45,47,48,49,50,51,52,53,55,64,73},
+	{ 2,11,20,27,28,29,36,37,38,45,46,48,49,50,51,52,53,56,65,74},
+	{ 3,12,21,30,31,32,39,40,41,45,46,47,49,50,51,52,53,57,66,75},
+	{ 4,13,22,30,31,32,39,40,41,45,46,47,48,50,51,52,53,58,67,76},
+	{ 5,14,23,30,31,32,39,40,41,45,46,47,48,49,51,52,53,59,68,77},
+	{ 6,15,24,33,34,35,42,43,44,45,46,47,48,49,50,52,53,60,69,78},
+	{ 7,16,25,33,34,35,42,43,44,45,46,47,48,49,50,51,53,61,70,79},
+	{ 8,17,26,33,34,35,42,43,44,45,46,47,48,49,50,51,52,62,71,80},
+	{ 0, 9,18,27,36,45,55,56,57,58,59,60,61,62,63,64,65,72,73,74},
+	{ 1,10,19,28,37,46,54,56,57,58,59,60,61,62,63,64,65,72,73,74},
+	{ 2,11,20,29,38,47,54,55,57,58,59,60,61,62,63,64,65,72,73,74},
+	{ 3,12,21,30,39,48,54,55,56,58,59,60,61,62,66,67,68,75,76,77},
+	{ 4,13,22,31,40,49,54,55,56,57,59,60,61,62,66,67,68,75,76,77},
+	{ 5,14,23,32,41,50,54,55,56,57,58,60,61,62,66,67,68,75,76,77},
+	{ 6,15,24,33,42,51,54,55,56,57,58,59,61,62,69,70,71,78,79,80},
+	{ 7,16,25,34,43,52,54,55,56,57,58,59,60,62,69,70,71,78,79,80},
+	{ 8,17,26,35,44,53,54,55,56,57,58,59,60,61,69,70,71,78,79,80},
+	{ 0, 9,18,27,36,45,54,55,56,64,65,66,67,68,69,70,71,72,73,74},
+	{ 1,10,19,28,37,46,54,55,56,63,65,66,67,68,69,70,71,72,73,74},
+	{ 2,11,20,29,38,47,54,55,56,63,64,66,67,68,69,70,71,72,73,74},
+	{ 3,12,21,30,39,48,57,58,59,63,64,65,67,68,69,70,71,75,76,77},
+	{ 4,13,22,31,40,49,57,58,59,63,64,65,66,68,69,70,71,75,76,77},
+	{ 5,14,23,32,41,50,57,58,59,63,64,65,66,67,69,70,71,75,76,77},
+	{ 6,15,24,33,42,51,60,61,62,63,64,65,66,67,68,70,71,78,79,80},
+	{ 7,16,25,34,43,52,60,61,62,63,64,65,66,67,68,69,71,78,79,80},
+	{ 8,17,26,35,44,53,60,61,62,63,64,65,66,67,68,69,70,78,79,80},
+	{ 0, 9,18,27,36,45,54,55,56,63,64,65,73,74,75,76,77,78,79,80},
+	{ 1,10,19,28,37,46,54,55,56,63,64,65,72,74,75,76,77,78,79,80},
+	{ 2,11,20,29,38,47,54,55,56,63,64,65,72,73,75,76,77,78,79,80},
+	{ 3,12,21,30,39,48,57,58,59,66,67,68,72,73,74,76,77,78,79,80},
+	{ 4,13,22,31,40,49,57,58,59,66,67,68,72,73,74,75,77,78,79,80},
+	{ 5,14,23,32,41,50,57,58,59,66,67,68,72,73,74,75,76,78,79,80},
+	{ 6,15,24,33,42,51,60,61,62,69,70,71,72,73,74,75,76,77,79,80},
+	{ 7,16,25,34,43,52,60,61,62,69,70,71,72,73,74,75,76,77,78,80},
+	{ 8,17,26,35,44,53,60,61,62,69,70,71,72,73,74,75,76,77,78,79}
+};
+
+
+
+/*---Declaration of functions (the functions of Sudoku.h, then the ones used only inside the library)
+	SudokuSolve:	Solves the puzzle with the engine and kernels of options, through function AnalyzeCell or SolveDLX, counting the search in stats (unless NULL).  Returns SUDOKUOK if solved, SUDOKUUNSOLVABLE, SUDOKUINVALID, SUDOKUUNSUPPORTED or SUDOKUABORTED
+	SudokuCount:	Counts the solutions of the puzzle, stopping at limit, through function CountCell or SolveDLX.  Returns SUDOKUOK if the puzzle has one solution, SUDOKUUNSOLVABLE, SUDOKUMULTIPLE, SUDOKUINVALID, SUDOKUUNSUPPORTED or SUDOKUABORTED
+	SudokuValidate:	Checks the values of the puzzle with ValidateBoard.  Returns SUDOKUOK or SUDOKUINVALID
+	SudokuSolveBig:	Solves a puzzle of any size, with SudokuSolve for a 9x9 puzzle, or with SolveBig16 or SolveBig25 (file SudokuBig.h).  Returns the same as SudokuSolve, or SUDOKUNOMEMORY
+	SudokuSolveSplit:	Solves one puzzle on several threads by splitting the search tree into subtrees at the first cells chosen for guessing.  Returns the same as SudokuSolve, or SUDOKUNOMEMORY
+	SudokuCheckOptions:	Checks the engine and kernels of the options.  Returns SUDOKUOK or SUDOKUUNSUPPORTED
+	ValidateBoard:	Checks that every value of the Board is 0-9 and that no value is repeated in a row, column or region, and records the values in the bitmasks.  Returns SUDOKUOK or SUDOKUINVALID
+	InitBudget:	Sets up the limits of a search from the budgets of the options.  Returns 1 if there is any limit, otherwise 0
+	OutOfBudget:	Counts a node of the search and checks it against the limits.  Returns 1 if the search must stop, otherwise 0
+	InitState:	Records the key values of the puzzle (already checked) in a search state and computes the candidates of each empty cell.  Returns 0 if a cell has no candidates, otherwise 1
+	SplitWorker:	Worker thread of SudokuSolveSplit, searches subtrees until all are searched or a solution is found by any thread
+	AnalyzeCell:	Solves the puzzle from a search state with CountCell, stopping at the first solution.  Returns 1 if solved (the board of the state holds the solution), otherwise 0 (also returns 0 at once if the search is stopped)
+	CountCell:	Searches from a search state by constraint propagation (function Propagate) and by trying each candidate of one cell on a copy of the state pushed on an explicit stack, until limit solutions are found.  Returns the number of solutions found (so far, if the search is stopped)
+	Propagate:	Places every value that can be deduced by naked singles, hidden singles and locked candidates, until nothing changes.  Returns 0 if a dead end is found, otherwise 1
+	LockedCandidates:	Removes candidates using locked candidates (pointing and claiming).  Returns 1 if any candidate was removed, otherwise 0
+	SelectCell:	Chooses the empty cell to guess next, the one with the fewest candidates
+	RulecheckPass:	Checks if a value can be placed in a cell according to the rules of Sudoku (1), otherwise returns 0
+	Change:		Places a value in a cell, records it in the row, column and region bitmasks, and removes it from the candidates of the peers of the cell.  Returns 0 if a peer is left with no candidates, otherwise 1
+	SolveDLX:	Solves a valid puzzle with the Dancing Links engine, or counts its solutions up to limit, counting the search in stats and checking it against budget (unless NULL).  Returns the number of solutions found (0 to limit)
+	BuildDLX:	Builds the exact cover matrix of an empty puzzle, copied by SolveDLX for each puzzle
+	SearchDLX:	Algorithm X, covers the column with the fewest rows left and tries each of its rows, recursing, until limit solutions are found.  Returns the number of solutions found (the first one is written to the Board)
+	CoverColumn:	Unlinks a column and every row crossing it from the exact cover matrix
+	UncoverColumn:	Links back a column unlinked by CoverColumn
+	SelectKernels:	Chooses the scalar, SSE4.2 or AVX2 kernels, or the best the processor supports.  Returns the kernels, or NULL if unknown or not supported by the processor
+	GetWallTime:	Returns the current wall clock time in seconds
+	ScanCellsScalar, ScanCellsSSE42, ScanCellsAVX2:	Kernels for ScanCells, find the empty cells with 0 or 1 candidates and the empty cells with the fewest candidates, in one pass over the candidate counts
+	ComputeCandidatesScalar, ComputeCandidatesSSE42:	Kernels for ComputeCandidates, compute the candidates and candidate count of every cell in one pass from the row, column and region bitmasks
+---*/
+static int ValidateBoard( const Board *board, Masks *masks );
+static int InitBudget( const SudokuOptions *options, size_t rootsize, size_t levelsize, Budget *budget );
+static int OutOfBudget( Budget *budget, int depth );
+static int InitState( const Board *board, const Masks *masks, const Kernels *kernels, SudokuStats *stats, Budget *budget, SearchState *state );
+static void *SplitWorker( void *arg );
+static int AnalyzeCell( SearchState *state );
+static int CountCell( SearchState *state, int limit, Board *solution );
+static int Propagate( SearchState *state );
+static int LockedCandidates( SearchState *state );
+static int SelectCell( const SearchState *state );
+static int RuleCheckPass( const Masks *masks, int cell, int val );
+static int Change( SearchState *state, int cell, int val );
+static int SolveDLX( Board *board, int limit, SudokuStats *stats, Budget *budget );
+static void BuildDLX( void );
+static int SearchDLX( DLX *dlx, int depth, Board *board, int limit );
+static void CoverColumn( DLX *dlx, int col );
+static void UncoverColumn( DLX *dlx, int col );
+static const Kernels *SelectKernels( int kernel );
+static double GetWallTime( void );
+static void ScanCellsScalar( const unsigned char *ncand, CellScan *scan );
+static void ComputeCandidatesScalar( SearchState *state );
+#ifdef X86KERNELS
+__attribute__((target("sse4.2"))) static void ScanCellsSSE42( const unsigned char *ncand, CellScan *scan );
+__attribute__((target("avx2"))) static void ScanCellsAVX2( const unsigned char *ncand, CellScan *scan );
+__attribute__((target("sse4.2"))) static void ComputeCandidatesSSE42( SearchState *state );
+#endif
+
+/*---Kernels chosen by SelectKernels, the scalar ones on any processor---*/
+static const Kernels scalarkernels = { ScanCellsScalar, ComputeCandidatesScalar };
+#ifdef X86KERNELS
+static const Kernels sse42kernels = { ScanCellsSSE42, ComputeCandidatesSSE42 };
+static const Kernels avx2kernels = { ScanCellsAVX2, ComputeCandidatesSSE42 };	//A row of 9 cells fits in 128 bits, so AVX2 has no advantage for ComputeCandidates
+#endif
+
+/*---Counting of the search into the SudokuStats of a search state or DLX matrix (when it has one), compiled out of the search altogether with -DNOSTATS (the time of each puzzle is still measured)---*/
+#ifdef NOSTATS
+#define COUNTSTAT(stats,field,num)	do { } while (0)
+#define DEPTHSTAT(stats,depth)		do { } while (0)
+#else
+#define COUNTSTAT(stats,field,num)	do { if ( (stats) != NULL ) (stats)->field += (num); } while (0)
+#define DEPTHSTAT(stats,depth)		do { if ( (stats) != NULL && (depth) > (stats)->maxdepth ) (stats)->maxdepth = (depth); } while (0)
+#endif
+
+/*---Check of the budget of a search at each node, a single test when the search has no limits---*/
+#define STOPPED(budget)	( (budget) != NULL && atomic_load_explicit( &(budget)->stop, memory_order_relaxed ) )
+
+/*---Exact cover matrix of an empty puzzle, built once by BuildDLX---*/
+static DLX dlxempty;
+static pthread_once_t dlxonce = PTHREAD_ONCE_INIT;
+
+/*---Solvers for 16x16 and 25x25 puzzles (SolveBig16 and SolveBig25), each one the template in SudokuBig.h included for its size---*/
+#define BIGDIM 16
+#define BIGREG 4
+#include "SudokuBig.h"
+#define BIGDIM 25
+#define BIGREG 5
+#include "SudokuBig.h"
+
+
+
+
+
+
+/*---SudokuSolve:	Solves the 9x9 puzzle by constraint propagation and guessing, through function AnalyzeCell, or with the Dancing Links engine (function SolveDLX), as chosen in options (NULL for the defaults), within the budgets of options.  If stats is not NULL, the search is counted in it and timed.  Returns SUDOKUOK if the puzzle was solved (the solution is written to solution, which may be the same array as puzzle), SUDOKUUNSOLVABLE if it has no solution, SUDOKUINVALID if a value is out of range or repeated, SUDOKUUNSUPPORTED if the options are, SUDOKUABORTED if a budget ran out or the search was cancelled first (solution is then unchanged, stats hold the search so far)---*/
+int SudokuSolve( const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options, SudokuStats *stats )
+{
+	/*---Define variables in function SudokuSolve---*/
+	SearchState state;								//State of the search, starting from the key values of the puzzle
+	Board board;									//The puzzle, then its solution
+	Masks masks;									//Bitmasks of the key values
+	Budget budget, *pbudget = NULL;							//Limits of the search, and pointer to them if there are any
+	const Kernels *kernels = SelectKernels( options != NULL ? options->kernel : SUDOKUKERNELAUTO );	//Kernels of the search
+	int engine = options != NULL ? options->engine : SUDOKUENGINEPROPAGATE;	//Engine solving the puzzle
+	int status, solved;								//Status returned, and 1 if the puzzle was solved
+	double start = 0.0;								//Wall clock time at start, if the search is timed
+	
+	
+	
+	if ( kernels == NULL || (engine != SUDOKUENGINEPROPAGATE && engine != SUDOKUENGINEDLX) )
+		return SUDOKUUNSUPPORTED;
+	if ( stats != NULL )
+	{
+		memset( stats, 0, sizeof(*stats) );
+		start = GetWallTime();
+	}
+	if ( engine == SUDOKUENGINEDLX ? InitBudget( options, sizeof(DLX), 0, &budget ) : InitBudget( options, sizeof(SearchState), sizeof(SearchState), &budget ) )
+		pbudget = &budget;
+	
+	/*---Check the initial (key) values of the puzzle, a value out of range or repeated in a row, column or region makes the puzzle invalid---*/
+	memcpy( board.cell, puzzle, 81 );
+	status = ValidateBoard( &board, &masks );
+	if ( status == SUDOKUOK )
+	{
+		if ( engine == SUDOKUENGINEDLX )
+			solved = SolveDLX( &board, 1, stats, pbudget );
+		else
+		{
+			/*---Record the key values and the candidates of each empty cell, then solve the puzzle through functions AnalyzeCell, Propagate, Change---*/
+			solved = InitState( &board, &masks, kernels, stats, pbudget, &state ) && AnalyzeCell( &state );
+			if ( solved )
+				board = state.board;
+		}
+		if ( !solved )
+			status = pbudget != NULL && atomic_load( &budget.aborted ) ? SUDOKUABORTED : SUDOKUUNSOLVABLE;
+	}
+	
+	if ( status == SUDOKUOK )
+		memcpy( solution, board.cell, 81 );
+	if ( stats != NULL )
+		stats->seconds = GetWallTime() - start;
+	
+	return status;
+}
+
+
+
+/*---SudokuCount:	Counts the solutions of the 9x9 puzzle with the engine of options (NULL for the defaults), stopping as soon as limit solutions are found, so a puzzle with no solution or many solutions is reported as quickly as one with exactly one.  The number of solutions found (0 to limit) is written to count (unless NULL), and if it is more than 0 the first solution found is written to solution (unless NULL).  If stats is not NULL, the search is counted in it and timed.  Returns SUDOKUOK if the puzzle has exactly one solution, SUDOKUUNSOLVABLE if none, SUDOKUMULTIPLE if more than one, SUDOKUINVALID if a value is out of range or repeated, SUDOKUUNSUPPORTED if the options are or limit is less than 1, SUDOKUABORTED if a budget of options ran out or the search was cancelled first (count is then the number of solutions found so far, and the first one is written to solution if there is one)---*/
+int SudokuCount( const unsigned char *puzzle, int limit, int *count, unsigned char *solution, const SudokuOptions *options, SudokuStats *stats )
+{
+	/*---Define variables in function SudokuCount---*/
+	SearchState state;								//State of the search, starting from the key values of the puzzle
+	Board board, first;								//The puzzle (board), and the first solution found (first)
+	Masks masks;									//Bitmasks of the key values
+	Budget budget, *pbudget = NULL;							//Limits of the search, and pointer to them if there are any
+	const Kernels *kernels = SelectKernels( options != NULL ? options->kernel : SUDOKUKERNELAUTO );	//Kernels of the search
+	int engine = options != NULL ? options->engine : SUDOKUENGINEPROPAGATE;	//Engine counting the solutions
+	int status, found = 0;								//Status returned, and number of solutions found
+	double start = 0.0;								//Wall clock time at start, if the search is timed
+	
+	
+	
+	if ( count != NULL )
+		*count = 0;
+	if ( kernels == NULL || (engine != SUDOKUENGINEPROPAGATE && engine != SUDOKUENGINEDLX) || limit < 1 )
+		return SUDOKUUNSUPPORTED;
+	if ( stats != NULL )
+	{
+		memset( stats, 0, sizeof(*stats) );
+		start = GetWallTime();
+	}
+	if ( engine == SUDOKUENGINEDLX ? InitBudget( options, sizeof(DLX), 0, &budget ) : InitBudget( options, sizeof(SearchState), sizeof(SearchState), &budget ) )
+		pbudget = &budget;
+	
+	memcpy( board.cell, puzzle, 81 );
+	status = ValidateBoard( &board, &masks );
+	if ( status == SUDOKUOK )
+	{
+		if ( engine == SUDOKUENGINEDLX )
+		{
+			found = SolveDLX( &board, limit, stats, pbudget );
+			first = board;
+		}
+		else if ( InitState( &board, &masks, kernels, stats, pbudget, &state ) )	//Otherwise a cell has no candidates, no solution
+			found = CountCell( &state, limit, &first );
+		if ( pbudget != NULL && atomic_load( &budget.aborted ) )
+			status = SUDOKUABORTED;
+		else
+			status = found == 0 ? SUDOKUUNSOLVABLE : found == 1 ? SUDOKUOK : SUDOKUMULTIPLE;
+	}
+	
+	if ( count != NULL )
+		*count = found;
+	if ( found > 0 && solution != NULL )
+		memcpy( solution, first.cell, 81 );
+	if ( stats != NULL )
+		stats->seconds = GetWallTime() - start;
+	
+	return status;
+}
+
+
+
+/*---SudokuValidate:	Checks that every value of the 9x9 puzzle is 0-9, and that no value is repeated in a row, column or region (function ValidateBoard).  The puzzle is not solved, so a valid puzzle may still have no solution.  Returns SUDOKUOK if the puzzle is valid, otherwise SUDOKUINVALID---*/
+int SudokuValidate( const unsigned char *puzzle )
+{
+	/*---Define variables in function SudokuValidate---*/
+	Board board;									//The puzzle
+	Masks masks;									//Bitmasks of the values, not used after
+	
+	
+	
+	memcpy( board.cell, puzzle, 81 );
+	return ValidateBoard( &board, &masks );
+}
+
+
+
+/*---SudokuSolveBig:	Solves a puzzle of size dim.  A 9x9 puzzle is solved with SudokuSolve, a 16x16 or 25x25 puzzle with SolveBig16 or SolveBig25 (the template in file SudokuBig.h), with the propagate engine and within the budgets of options (NULL for no limits, the kernels of options are only used for 9x9).  Returns SUDOKUOK if the puzzle was solved (the solution is written to solution, which may be the same array as puzzle), SUDOKUUNSOLVABLE if it has no solution, SUDOKUINVALID if a value is out of range or repeated, SUDOKUUNSUPPORTED if dim is not 9, 16 or 25 or the engine is not the propagate engine, SUDOKUNOMEMORY if the search stack of a 16x16 or 25x25 puzzle could not be allocated, SUDOKUABORTED if a budget ran out or the search was cancelled first---*/
+int SudokuSolveBig( int dim, const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options )
+{
+	if ( options != NULL && options->engine != SUDOKUENGINEPROPAGATE )
+		return SUDOKUUNSUPPORTED;
+	switch ( dim )
+	{
+		case 9:
+			return SudokuSolve( puzzle, solution, options, NULL );
+		case 16:
+			return SolveBig16( puzzle, solution, options );
+		case 25:
+			return SolveBig25( puzzle, solution, options );
+		default:
+			return SUDOKUUNSUPPORTED;
+	}
+}
+
+
+
+/*---SudokuSolveSplit:	Solves the 9x9 puzzle on numthreads threads (the calling thread and numthreads-1 more) with the propagate engine and the kernels of options (NULL for the defaults), within the budgets of options (the nodes and time of all threads together, and the memory of each thread).  The search tree is split into subtrees (tasks) by expanding it one level at a time, the same way AnalyzeCell does (propagate, then one copy of the state per candidate of the most constrained cell, chosen by SelectCell), until there are about SPLITTASKS tasks per thread.  Worker threads (function SplitWorker) take tasks in order and search them with AnalyzeCell, and the first thread to find a solution stops the others.  If a thread cannot be started, the threads already running search all the tasks.  If the puzzle has more than one solution, any one of them may be returned.  Unlike the other functions, this one allocates memory (the tasks and threads) for each call.  Returns SUDOKUOK if the puzzle was solved (the solution is written to solution), SUDOKUUNSOLVABLE if it has no solution, SUDOKUINVALID if a value is out of range or repeated, SUDOKUUNSUPPORTED if the options are (or the engine is not the propagate engine), SUDOKUNOMEMORY if memory could not be allocated, SUDOKUABORTED if a budget ran out or the search was cancelled first---*/
+#define SPLITTASKS 8
+int SudokuSolveSplit( const unsigned char *puzzle, unsigned char *solution, int numthreads, const SudokuOptions *options )
+{
+	/*---Define variables in function SudokuSolveSplit---*/
+	SplitSearch search;								//Search shared by the worker threads
+	SplitThread *threads;								//The worker threads, threads[0] is the calling thread
+	SearchState *next;								//Tasks one level deeper than the current ones
+	Board board;									//The puzzle
+	Masks masks;									//Bitmasks of the key values
+	const Kernels *kernels = SelectKernels( options != NULL ? options->kernel : SUDOKUKERNELAUTO );	//Kernels of the search
+	unsigned short cands;								//Candidates of the cell being expanded
+	long ind, numnext;								//Generic use index in loops (ind), and number of tasks in next (numnext)
+	int th, started, cell, val, expanded, status;					//Index of worker thread (th), number of threads started (started), cell being expanded (cell), value placed in it (val), 1 if any task was expanded this level (expanded), and status returned (status)
+	
+	
+	
+	if ( kernels == NULL || (options != NULL && options->engine != SUDOKUENGINEPROPAGATE) )
+		return SUDOKUUNSUPPORTED;
+	if ( numthreads < 1 )
+		numthreads = 1;
+	
+	memcpy( board.cell, puzzle, 81 );
+	if ( (status = ValidateBoard( &board, &masks )) != SUDOKUOK )
+		return status;
+	
+	memset( &search, 0, sizeof(search) );
+	InitBudget( options, sizeof(SearchState), sizeof(SearchState), &search.budget );	//Used by the threads to stop each other even with no limits
+	threads = (SplitThread *)malloc( numthreads*sizeof(SplitThread) );
+	search.tasks = (SearchState *)malloc( sizeof(SearchState) );
+	if ( threads == NULL || search.tasks == NULL )
+	{
+		free( search.tasks );
+		free( threads );
+		return SUDOKUNOMEMORY;
+	}
+	if ( !InitState( &board, &masks, kernels, NULL, &search.budget, &search.tasks[0] ) )
+	{
+		free( search.tasks );
+		free( threads );
+		return SUDOKUUNSOLVABLE;
+	}
+	search.numtasks = 1;								//Start with one task, the whole search tree
+	
+	
+	
+	/*---Expand the tasks one level at a time, until there are enough tasks for all threads (or all tasks are solved, or there is no task left)---*/
+	do
+	{
+		next = (SearchState *)malloc( search.numtasks*9*sizeof(SearchState) );
+		if ( next == NULL )
+		{
+			free( search.tasks );
+			free( threads );
+			return SUDOKUNOMEMORY;
+		}
+		numnext = 0;
+		expanded = 0;
+		for ( ind=0; ind<search.numtasks; ind++ )
+		{
+			if ( !Propagate( &search.tasks[ind] ) )				//Dead end, drop the task
+				continue;
+			if ( search.tasks[ind].numempty == 0 )				//Already solved, keep the task as it is
+			{
+				next[numnext++] = search.tasks[ind];
+				continue;
+			}
+			cell = SelectCell( &search.tasks[ind] );
+			cands = search.tasks[ind].cand[cell];
+			while ( cands )
+			{
+				val = __builtin_ctz( cands ) + 1;
+				cands &= (unsigned short)( cands - 1 );
+				next[numnext] = search.tasks[ind];
+				if ( Change( &next[numnext], cell, val ) )
+					numnext++;
+			}
+			expanded = 1;
+		}
+		free( search.tasks );
+		search.tasks = next;
+		search.numtasks = numnext;
+	}
+	while ( expanded && search.numtasks > 0 && search.numtasks < (long)SPLITTASKS*numthreads );
+	
+	
+	
+	/*---Search the subtrees on the worker threads and on the calling thread, the first solution found is copied to solution---*/
+	atomic_init( &search.nexttask, 0 );
+	atomic_init( &search.found, 0 );
+	for ( th=0; th<numthreads; th++ )
+		threads[th].search = &search;
+	for ( started=1; started<numthreads; started++ )
+	{
+		if ( pthread_create( &threads[started].thread, NULL, SplitWorker, &threads[started] ) != 0 )
+			break;
+	}
+	SplitWorker( &threads[0] );
+	for ( th=1; th<started; th++ )
+		pthread_join( threads[th].thread, NULL );
+	
+	status = atomic_load( &search.found ) ? SUDOKUOK : atomic_load( &search.budget.aborted ) ? SUDOKUABORTED : SUDOKUUNSOLVABLE;
+	if ( status == SUDOKUOK )
+		memcpy( solution, search.solution.cell, 81 );
+	
+	free( search.tasks );
+	free( threads );
+	
+	return status;
+}
+
+
+
+/*---SplitWorker:	Worker thread of SudokuSolveSplit, takes the next subtree (task) of the search and searches it with AnalyzeCell, until all tasks are searched or the search is stopped, by a solution found on any thread or by the budget---*/
+static void *SplitWorker( void *arg )
+{
+	/*---Define variables in function SplitWorker---*/
+	SplitSearch *search = ((SplitThread *)arg)->search;				//Search shared by the worker threads
+	long ind;									//Index of the task being searched
+	
+	
+	
+	while ( !STOPPED( &search->budget ) && (ind = atomic_fetch_add( &search->nexttask, 1 )) < search->numtasks )
+	{
+		if ( AnalyzeCell( &search->tasks[ind] ) )
+		{
+			if ( atomic_exchange( &search->found, 1 ) == 0 )		//Only the first thread to find a solution copies it
+			{
+				search->solution = search->tasks[ind].board;
+				atomic_store( &search->budget.stop, 1 );
+			}
+		}
+	}
+	
+	return NULL;
+}
+
+
+
+/*---InitBudget:	Sets up the limits of a search from the budgets of options (none if options is NULL), for a search whose state takes rootsize bytes to start with and levelsize more bytes for each level of guessing (0 if its memory does not grow with the depth).  The memory budget becomes the deepest level of guessing allowed (maxdepth, -1 if not even rootsize fits):  it only bounds the memory used by a search that allocates its levels as it goes deeper (SolveBig), the 9x9 search reserves its whole SearchStack whatever the budget, so there it is a cap on the depth.  The time budget starts now.  Returns 1 if the search has any limit (or a cancel flag), otherwise 0 (budget is then set up with no limits)---*/
+static int InitBudget( const SudokuOptions *options, size_t rootsize, size_t levelsize, Budget *budget )
+{
+	memset( budget, 0, sizeof(*budget) );
+	atomic_init( &budget->nodes, 0 );
+	atomic_init( &budget->stop, 0 );
+	atomic_init( &budget->aborted, 0 );
+	budget->maxdepth = INT_MAX;
+	if ( options == NULL || (options->maxnodes <= 0 && options->maxseconds <= 0.0 && options->maxmemory <= 0 && options->cancel == NULL) )
+		return 0;
+	
+	budget->maxnodes = options->maxnodes > 0 ? options->maxnodes : 0;
+	budget->deadline = options->maxseconds > 0.0 ? GetWallTime() + options->maxseconds : 0.0;
+	budget->cancel = options->cancel;
+	if ( options->maxmemory > 0 && (size_t)options->maxmemory < rootsize )
+		budget->maxdepth = -1;
+	else if ( options->maxmemory > 0 && levelsize > 0 && ((size_t)options->maxmemory - rootsize)/levelsize < INT_MAX )
+		budget->maxdepth = (int)( ((size_t)options->maxmemory - rootsize)/levelsize );
+	
+	return 1;
+}
+
+
+
+/*---OutOfBudget:	Counts one node of the search, at level depth of guessing, and checks it against the limits of budget:  the nodes visited, the depth allowed by the memory budget, the cancel flag, and the wall clock (read once every BUDGETCLOCK nodes).  If any is exceeded, the search is marked aborted and stopped on every thread.  Returns 1 if the search must stop (also if it was already stopped), otherwise 0---*/
+static int OutOfBudget( Budget *budget, int depth )
+{
+	/*---Define variables in function OutOfBudget---*/
+	long nodes;									//Nodes visited, with this one
+	
+	
+	
+	if ( atomic_load_explicit( &budget->stop, memory_order_relaxed ) )
+		return 1;
+	nodes = atomic_fetch_add_explicit( &budget->nodes, 1, memory_order_relaxed ) + 1;
+	if ( (budget->maxnodes > 0 && nodes > budget->maxnodes) || depth > budget->maxdepth
+		|| (budget->cancel != NULL && __atomic_load_n( budget->cancel, __ATOMIC_RELAXED ))
+		|| (budget->deadline > 0.0 && nodes % BUDGETCLOCK == 0 && GetWallTime() > budget->deadline) )
+	{
+		atomic_store( &budget->aborted, 1 );
+		atomic_store( &budget->stop, 1 );
+		return 1;
+	}
+	
+	return 0;
+}
+
+
+
+/*---InitState:	Records the initial (key) values of the puzzle in the search state, with the bitmasks of the key values already checked by ValidateBoard, and computes the candidates of each empty cell with the kernels of the search.  The search is counted in stats and checked against budget (unless NULL).  Returns 0 if an empty cell has no candidates (the puzzle has no solution), otherwise 1---*/
+static int InitState( const Board *board, const Masks *masks, const Kernels *kernels, SudokuStats *stats, Budget *budget, SearchState *state )
+{
+	/*---Define variables in function InitState---*/
+	int cell;									//Generic use cell of the Board
+	CellScan scan;									//Scan of the candidate counts, for an empty cell with no candidates
+	
+	
+	
+	memset( state, 0, sizeof(*state) );
+	state->board = *board;
+	state->masks = *masks;
+	state->kernels = kernels;
+	state->stats = stats;
+	state->budget = budget;
+	for ( cell=0; cell<81; cell++ )
+		state->numempty += ( board->cell[cell] == 0 );
+	
+	memset( state->ncand + 81, CELLFILLED, sizeof(state->ncand) - 81 );
+	kernels->ComputeCandidates( state );						//Candidates of all cells in one pass
+	kernels->ScanCells( state->ncand, &scan );
+	
+	return scan.fewest != 0;
+}
+
+
+
+/*---ValidateBoard:	Checks the initial (key) values of the puzzle, each must be 0 (an empty cell) to 9, and no value may be repeated in a row, column or region (function RuleCheckPass).  The values are recorded in masks as they are checked.  Returns SUDOKUOK if the puzzle is valid, otherwise SUDOKUINVALID---*/
+static int ValidateBoard( const Board *board, Masks *masks )
+{
+	/*---Define variables in function ValidateBoard---*/
+	int cell, val;									//Generic use cell of the Board (cell), and value of a cell (val)
+	
+	
+	
+	memset( masks, 0, sizeof(*masks) );
+	for ( cell=0; cell<81; cell++ )							//Loop through cells of the Board checking the key values
+	{
+		val = board->cell[cell];
+		if ( val == 0 )
+			continue;
+		if ( val > 9 || !RuleCheckPass( masks, cell, val ) )
+			return SUDOKUINVALID;
+		masks->row[cellrow[cell]] |= (unsigned short)( 1 << (val-1) );
+		masks->col[cellcol[cell]] |= (unsigned short)( 1 << (val-1) );
+		masks->reg[cellreg[cell]] |= (unsigned short)( 1 << (val-1) );
+	}
+	
+	return SUDOKUOK;
+}
+
+
+
+/*---SudokuCheckOptions:	Checks that the engine of options is known, and that its kernels are known and supported by the processor (function SelectKernels), so a program can check its options once before solving any puzzle.  Returns SUDOKUOK if so, otherwise SUDOKUUNSUPPORTED---*/
+int SudokuCheckOptions( const SudokuOptions *options )
+{
+	if ( options != NULL && options->engine != SUDOKUENGINEPROPAGATE && options->engine != SUDOKUENGINEDLX )
+		return SUDOKUUNSUPPORTED;
+	return SelectKernels( options != NULL ? options->kernel : SUDOKUKERNELAUTO ) != NULL ? SUDOKUOK : SUDOKUUNSUPPORTED;
+}
+
+
+
+/*---AnalyzeCell:	Solves the puzzle from a search state, with CountCell stopping at the first solution, which is written to the board of the state.  Returns 1 if the puzzle was solved, 0 if there is no solution from this state, or if the search was stopped (budget ran out, search cancelled, or a solution found by another thread of SudokuSolveSplit)---*/
+static int AnalyzeCell( SearchState *state )
+{
+	return CountCell( state, 1, &state->board );
+}
+
+
+
+/*---CountCell:	Counts the solutions from a search state, until limit solutions are found or the whole search tree is searched, in one loop over an explicit stack (SearchStack) instead of recursion.  The node on top of the stack is searched first:  Propagate places every value that can be deduced, then the empty cell chosen by SelectCell is guessed, each of its candidates placed with Change on a copy of the state pushed on the stack.  When a node is a dead end or a solution, or all candidates of its cell are tried, it is popped and the level before tries its next candidate.  The state itself is not changed, the search works on a copy (level 0).  The first solution found is copied to solution (unless solution is NULL).  If the state has a budget, each node is checked against it (function OutOfBudget), and once the search is stopped the solutions found so far are returned at once.  Returns the number of solutions found (0 to limit)---*/
+static int CountCell( SearchState *state, int limit, Board *solution )
+{
+	/*---Define variables in function CountCell---*/
+	SearchStack stack;								//Copy of the state at each level of guessing, and the cell guessed there
+	SearchState *node;								//State of the node on top of the stack
+	unsigned short cands;								//Candidates of the cell being guessed, not tried yet
+	int top = 0, count = 0, done, val;						//Level on top of the stack (top), number of solutions found (count), 1 if the node on top of the stack is finished with (done), and value being tried (val)
+	
+	
+	
+	stack.level[0] = *state;
+	for ( ;; )
+	{
+		/*---Search the node on top of the stack:  it is finished with if it is a dead end or a solution, otherwise the cell to guess at its level is chosen---*/
+		node = &stack.level[top];
+		if ( node->budget != NULL && OutOfBudget( node->budget, node->depth ) )	//Budget ran out, or search stopped, stop searching
+			return count;
+		COUNTSTAT( node->stats, nodes, 1 );
+		DEPTHSTAT( node->stats, node->depth );
+		done = 1;
+		if ( Propagate( node ) )						//Otherwise a dead end, no solution from here
+		{
+			if ( node->numempty == 0 )					//All cells are filled in, one solution
+			{
+				if ( count == 0 && solution != NULL )
+					*solution = node->board;
+				count++;
+			}
+			else
+			{
+				stack.cell[top] = (unsigned char)SelectCell( node );
+				stack.cands[top] = node->cand[stack.cell[top]];
+				done = 0;
+			}
+		}
+		
+		/*---Pop the levels finished with, until a level has a candidate left to try (and the limit is not reached), then push a copy of its state with the candidate placed---*/
+		for ( ;; )
+		{
+			if ( done )
+			{
+				if ( top == 0 )						//The whole search tree is searched
+					return count;
+				top--;
+				if ( STOPPED( stack.level[top].budget ) )
+					return count;
+				if ( count == stack.count[top] )			//The guess led to a dead end
+					COUNTSTAT( stack.level[top].stats, backtracks, 1 );
+			}
+			cands = stack.cands[top];
+			if ( cands == 0 || count >= limit )				//Tried all candidates for this cell, or enough solutions found
+			{
+				done = 1;
+				continue;
+			}
+			val = __builtin_ctz( cands ) + 1;				//Lowest value first
+			stack.cands[top] = (unsigned short)( cands & (cands - 1) );
+			stack.count[top] = count;
+			stack.level[top+1] = stack.level[top];
+			top++;
+			stack.level[top].depth++;
+			if ( Change( &stack.level[top], stack.cell[top-1], val ) )
+				break;							//Search the new node
+			done = 1;							//Dead end at once, pop it
+		}
+	}
+}
+
+
+
+/*---Propagate:	Constraint propagation, places every value that can be deduced, and repeats until nothing changes:  1) naked singles, an empty cell with only one candidate, 2) hidden singles, a value that is a candidate in only one cell of a row, column or region, and 3) if no single is found, locked candidates (function LockedCandidates).  Returns 0 if a dead end is found (an empty cell with no candidates, or a value with no possible cell in a row, column or region), otherwise 1---*/
+static int Propagate( SearchState *state )
+{
+	/*---Define variables in function Propagate---*/
+	unsigned short once, twice, placed, hidden, bit, c;				//Candidates found at least once (once) and at least twice (twice) in a unit, values placed in the unit (placed), values with one possible cell (hidden), generic use bit (bit) and candidates (c)
+	int changed, cell, unit, ind;							//1 if anything changed this pass (changed), generic use cell (cell), unit (unit) and index (ind)
+	unsigned int low;								//Cells with 0 or 1 candidates not placed yet, in one word of scan.low
+	CellScan scan;									//Scan of the candidate counts
+	
+	
+	
+	do
+	{
+		changed = 0;
+		
+		/*---Naked singles, found with one pass of the ScanCells kernel---*/
+		state->kernels->ScanCells( state->ncand, &scan );
+		for ( ind=0; ind<3; ind++ )
+		{
+			for ( low=scan.low[ind]; low; low &= low-1 )
+			{
+				cell = ind*32 + __builtin_ctz( low );
+				if ( state->ncand[cell] == 0 )				//No candidates left, also when a single placed before took the last one
+					return 0;
+				if ( !Change( state, cell, __builtin_ctz( state->cand[cell] ) + 1 ) )
+					return 0;
+				COUNTSTAT( state->stats, propagations, 1 );
+				changed = 1;
+			}
+		}
+		
+		/*---Hidden singles, units 0-8 are rows, 9-17 columns and 18-26 regions---*/
+		for ( unit=0; unit<27; unit++ )
+		{
+			once = twice = 0;
+			for ( ind=0; ind<9; ind++ )
+			{
+				c = state->cand[units[unit][ind]];
+				twice |= once & c;
+				once |= c;
+			}
+			placed = unit < 9 ? state->masks.row[unit] : unit < 18 ? state->masks.col[unit-9] : state->masks.reg[unit-18];
+			if ( (once | placed) != 0x1FF )					//A value has no possible cell in this unit
+				return 0;
+			
+			hidden = once & ~twice;
+			while ( hidden )
+			{
+				bit = hidden & (unsigned short)( -hidden );
+				hidden &= (unsigned short)~bit;
+				for ( ind=0; ind<9; ind++ )
+				{
+					cell = units[unit][ind];
+					if ( state->cand[cell] & bit )				//If the cell already lost this candidate to another hidden single of this unit, the next pass finds the dead end
+					{
+						if ( !Change( state, cell, __builtin_ctz( bit ) + 1 ) )
+							return 0;
+						COUNTSTAT( state->stats, propagations, 1 );
+						changed = 1;
+						break;
+					}
+				}
+			}
+		}
+		
+		/*---Locked candidates, only when there are no singles left---*/
+		if ( !changed )
+			changed = LockedCandidates( state );
+	}
+	while ( changed && state->numempty > 0 );
+	
+	return 1;
+}
+
+
+
+/*---LockedCandidates:	For each region and each row or column crossing it, compares the candidates in the 3 cells where they cross with the candidates in the rest of the region and the rest of the row or column.  1) Pointing:  a value that is a candidate in the region only where it crosses the row or column must go there, so it is removed from the rest of the row or column.  2) Claiming:  a value that is a candidate in the row or column only where it crosses the region is removed from the rest of the region.  Returns 1 if any candidate was removed, otherwise 0---*/
+static int LockedCandidates( SearchState *state )
+{
+	/*---Define variables in function LockedCandidates---*/
+	unsigned short inter, restline, restreg, pointing, claiming;			//Candidates where the region and line cross (inter), in the rest of the line (restline) and the rest of the region (restreg), and values to remove by pointing and claiming
+	int reg, isrow, line, unit, cell, ind, changed = 0;				//Region (reg), 1 for rows and 0 for columns (isrow), row or column (line) and its unit (unit), generic use cell (cell) and index (ind), and 1 if any candidate was removed (changed)
+	
+	
+	
+	for ( reg=0; reg<9; reg++ )
+	{
+		for ( isrow=0; isrow<2; isrow++ )
+		{
+			for ( line=0; line<3; line++ )
+			{
+				unit = isrow ? (reg/3)*3 + line : 9 + (reg%3)*3 + line;
+				inter = restline = restreg = 0;
+				for ( ind=0; ind<9; ind++ )
+				{
+					cell = units[unit][ind];
+					if ( cellreg[cell] == reg )
+						inter |= state->cand[cell];
+					else
+						restline |= state->cand[cell];
+					
+					cell = units[18+reg][ind];
+					if ( (isrow ? cellrow[cell] : 9 + cellcol[cell]) != unit )
+						restreg |= state->cand[cell];
+				}
+				
+				pointing = inter & restline & (unsigned short)~restreg;
+				claiming = inter & restreg & (unsigned short)~restline;
+				if ( pointing == 0 && claiming == 0 )
+					continue;
+				
+				changed = 1;
+				for ( ind=0; ind<9; ind++ )
+				{
+					cell = units[unit][ind];
+					if ( cellreg[cell] != reg && (state->cand[cell] & pointing) )
+					{
+						COUNTSTAT( state->stats, propagations, __builtin_popcount( state->cand[cell] & pointing ) );
+						state->cand[cell] &= (unsigned short)~pointing;
+						state->ncand[cell] = (unsigned char)__builtin_popcount( state->cand[cell] );
+					}
+					
+					cell = units[18+reg][ind];
+					if ( (isrow ? cellrow[cell] : 9 + cellcol[cell]) != unit && (state->cand[cell] & claiming) )
+					{
+						COUNTSTAT( state->stats, propagations, __builtin_popcount( state->cand[cell] & claiming ) );
+						state->cand[cell] &= (unsigned short)~claiming;
+						state->ncand[cell] = (unsigned char)__builtin_popcount( state->cand[cell] );
+					}
+				}
+			}
+		}
+	}
+	
+	return changed;
+}
+
+
+
+/*---SelectCell:	Chooses the empty cell to guess next, the one with the fewest candidates (most constrained cell), using the candidate counts kept by Change, scanned by the ScanCells kernel.  Ties are broken by the number of empty peers (the cell that constrains the most other cells), then by the first cell in row-major order---*/
+static int SelectCell( const SearchState *state )
+{
+	/*---Define variables in function SelectCell---*/
+	CellScan scan;									//Scan of the candidate counts, the cells with the fewest candidates are in scan.best
+	unsigned int bits;								//Cells with the fewest candidates not looked at yet, in one word of scan.best
+	int cell, best = -1;								//Generic use cell (cell), and cell chosen so far (best)
+	int ind, word, degree, bestdegree = -1;						//Generic use index (ind), word of scan.best (word), number of empty peers of a cell (degree), and of the cell chosen so far (bestdegree)
+	
+	
+	
+	/*---Fewest candidates, the search never gets here with a cell of 0 or 1 candidates (Propagate fills in naked singles), so 2 is the best possible---*/
+	state->kernels->ScanCells( state->ncand, &scan );
+	
+	/*---Tie-breaker, most empty peers---*/
+	for ( word=0; word<3; word++ )
+	{
+		for ( bits=scan.best[word]; bits; bits &= bits-1 )
+		{
+			cell = word*32 + __builtin_ctz( bits );
+			degree = 0;
+			for ( ind=0; ind<20; ind++ )
+				degree += ( state->board.cell[peers[cell][ind]] == 0 );
+			if ( degree > bestdegree )
+			{
+				bestdegree = degree;
+				best = cell;
+			}
+		}
+	}
+	
+	return best;
+}
+
+
+
+/*---RuleCheckPass:	Checks if value val can be placed in the cell according to the rules of Sudoku (returns 1), and if not, returns 0---*/
+static int RuleCheckPass( const Masks *masks, int cell, int val )
+{
+	/*---Check if value is already used in the row, the column or the region (3x3 grid is a region) of the cell---*/
+	return !( (masks->row[cellrow[cell]] | masks->col[cellcol[cell]] | masks->reg[cellreg[cell]]) & (1 << (val-1)) );
+}
+
+
+
+/*---Change:	Places value val in the cell, records it in the row, column and region bitmasks, and removes it from the candidates of the 20 peers of the cell.  Returns 0 if an empty peer is left with no candidates (a dead end), otherwise 1---*/
+static int Change( SearchState *state, int cell, int val )
+{
+	/*---Define variables in function Change---*/
+	unsigned short bit = (unsigned short)( 1 << (val-1) );				//Bit representing the value placed in the cell
+	int ind, peer;									//Generic use index (ind), and peer of the cell (peer)
+	
+	
+	
+	state->board.cell[cell] = (unsigned char)val;
+	state->cand[cell] = 0;
+	state->ncand[cell] = CELLFILLED;
+	state->numempty--;
+	state->masks.row[cellrow[cell]] |= bit;
+	state->masks.col[cellcol[cell]] |= bit;
+	state->masks.reg[cellreg[cell]] |= bit;
+	
+	for ( ind=0; ind<20; ind++ )
+	{
+		peer = peers[cell][ind];
+		if ( state->cand[peer] & bit )
+		{
+			state->cand[peer] &= (unsigned short)~bit;
+			COUNTSTAT( state->stats, eliminations, 1 );
+			if ( --state->ncand[peer] == 0 )
+				return 0;
+		}
+	}
+	
+	return 1;
+}
+
+
+
+/*---SolveDLX:	Solves the puzzle (its key values already checked by ValidateBoard) as an exact cover problem with Knuth's Dancing Links (Algorithm X).  The matrix of an empty puzzle (built once by BuildDLX) is copied, the rows of the key values are chosen by covering their columns, and SearchDLX finds the rows of the empty cells, stopping after limit solutions (1 to just solve the puzzle).  Returns the number of solutions found (0 to limit), if it is more than 0 the first solution found is written to board.  If stats is not NULL, the search is counted in it, and if budget is not NULL, it is checked against it (the number of solutions found so far is returned if it runs out)---*/
+static int SolveDLX( Board *board, int limit, SudokuStats *stats, Budget *budget )
+{
+	/*---Define variables in function SolveDLX---*/
+	DLX dlx;									//Exact cover matrix of the puzzle, a copy of the one of an empty puzzle
+	int cell, val, ind, node;							//Generic use cell (cell), value of a cell (val), index (ind), and node of the matrix (node)
+	
+	
+	
+	pthread_once( &dlxonce, BuildDLX );
+	dlx = dlxempty;
+	dlx.stats = stats;
+	dlx.budget = budget;
+	
+	/*---Choose the rows of the key values---*/
+	for ( cell=0; cell<81; cell++ )
+	{
+		val = board->cell[cell];
+		if ( val == 0 )
+			continue;
+		node = DLXFIRSTNODE + (cell*9 + val-1)*4;
+		for ( ind=0; ind<4; ind++ )
+			CoverColumn( &dlx, dlx.column[node+ind] );
+	}
+	
+	return SearchDLX( &dlx, 0, board, limit );
+}
+
+
+
+/*---BuildDLX:	Builds in dlxempty the exact cover matrix of an empty puzzle, 324 columns (81 for the cells, then 81 each for the values in the rows, the columns and the regions) and 729 rows (one for each value in each cell), each row with 4 nodes.  Called once through pthread_once---*/
+static void BuildDLX( void )
+{
+	/*---Define variables in function BuildDLX---*/
+	DLX *dlx = &dlxempty;								//The matrix being built
+	int col, row, cell, digit, ind, node;						//Column header (col), row of the matrix (row), its cell (cell) and digit 0-8 (digit), generic use index (ind), and node of the matrix (node)
+	int cols[4];									//Columns of the 4 nodes of a row
+	
+	
+	
+	/*---Column headers in a circular list with the root, each column starting empty---*/
+	for ( col=0; col<DLXFIRSTNODE; col++ )
+	{
+		dlx->left[col] = (unsigned short)( col == 0 ? DLXCOLUMNS : col-1 );
+		dlx->right[col] = (unsigned short)( col == DLXCOLUMNS ? 0 : col+1 );
+		dlx->up[col] = dlx->down[col] = dlx->column[col] = (unsigned short)col;
+		dlx->size[col] = 0;
+	}
+	
+	/*---Rows, each node added at the bottom of its column---*/
+	for ( row=0; row<729; row++ )
+	{
+		cell = row/9;
+		digit = row%9;
+		cols[0] = 1 + cell;
+		cols[1] = 1 + 81 + cellrow[cell]*9 + digit;
+		cols[2] = 1 + 162 + cellcol[cell]*9 + digit;
+		cols[3] = 1 + 243 + cellreg[cell]*9 + digit;
+		for ( ind=0; ind<4; ind++ )
+		{
+			node = DLXFIRSTNODE + row*4 + ind;
+			col = cols[ind];
+			dlx->left[node] = (unsigned short)( DLXFIRSTNODE + row*4 + (ind+3)%4 );
+			dlx->right[node] = (unsigned short)( DLXFIRSTNODE + row*4 + (ind+1)%4 );
+			dlx->column[node] = (unsigned short)col;
+			dlx->up[node] = dlx->up[col];
+			dlx->down[node] = (unsigned short)col;
+			dlx->down[dlx->up[col]] = (unsigned short)node;
+			dlx->up[col] = (unsigned short)node;
+			dlx->size[col]++;
+		}
+	}
+}
+
+
+
+/*---SearchDLX:	Algorithm X, at level depth of the search.  If no column is left, the rows chosen (in solution) are written to board (unless board is NULL).  Otherwise the column with the fewest rows left is covered, and each of its rows is tried in turn by covering the other columns of the row and recursing, then uncovering them, until limit solutions are found.  Returns the number of solutions found from here (0 to limit), when it is less than limit the matrix is as it was on entry (unless the search was stopped by its budget, the matrix is then not needed any more)---*/
+static int SearchDLX( DLX *dlx, int depth, Board *board, int limit )
+{
+	/*---Define variables in function SearchDLX---*/
+	int col, best, node, other, ind, row;						//Generic use column (col), column with the fewest rows (best), row being tried (node), other node of the row (other), generic use index (ind), and row of the matrix (row)
+	int count = 0, found;								//Number of solutions found, and found with the row being tried (found)
+	
+	
+	
+	if ( dlx->budget != NULL && OutOfBudget( dlx->budget, depth ) )		//Budget ran out, stop searching
+		return 0;
+	
+	COUNTSTAT( dlx->stats, nodes, 1 );
+	DEPTHSTAT( dlx->stats, depth );
+	if ( dlx->right[DLXROOT] == DLXROOT )						//All columns covered, the puzzle is solved
+	{
+		for ( ind=0; ind<depth && board != NULL; ind++ )
+		{
+			row = dlx->solution[ind];
+			board->cell[row/9] = (unsigned char)( row%9 + 1 );
+		}
+		return 1;
+	}
+	
+	/*---Column with the fewest rows left, stop looking at 1 (0 is a dead end, found at once too)---*/
+	best = dlx->right[DLXROOT];
+	for ( col=dlx->right[best]; col != DLXROOT && dlx->size[best] > 1; col=dlx->right[col] )
+	{
+		if ( dlx->size[col] < dlx->size[best] )
+			best = col;
+	}
+	if ( dlx->size[best] == 0 )							//Dead end, there is a problem further back
+		return 0;
+	
+	CoverColumn( dlx, best );
+	for ( node=dlx->down[best]; node != best; node=dlx->down[node] )
+	{
+		dlx->solution[depth] = (unsigned short)( (node - DLXFIRSTNODE)/4 );
+		for ( other=dlx->right[node]; other != node; other=dlx->right[other] )
+			CoverColumn( dlx, dlx->column[other] );
+		
+		found = SearchDLX( dlx, depth+1, count == 0 ? board : NULL, limit - count );
+		if ( STOPPED( dlx->budget ) )
+			return count + found;
+		if ( found == 0 )
+			COUNTSTAT( dlx->stats, backtracks, 1 );
+		count += found;
+		if ( count >= limit )							//Enough solutions, the matrix is not needed any more
+			return count;
+		
+		for ( other=dlx->left[node]; other != node; other=dlx->left[other] )
+			UncoverColumn( dlx, dlx->column[other] );
+	}
+	UncoverColumn( dlx, best );
+	
+	return count;									//Tried all rows of this column
+}
+
+
+
+/*---CoverColumn:	Unlinks column col from the list of columns, and unlinks every row with a node in column col from the other columns it has nodes in---*/
+static void CoverColumn( DLX *dlx, int col )
+{
+	/*---Define variables in function CoverColumn---*/
+	int node, other;								//Node of column col (node), and other node of its row (other)
+	
+	
+	
+	dlx->right[dlx->left[col]] = dlx->right[col];
+	dlx->left[dlx->right[col]] = dlx->left[col];
+	for ( node=dlx->down[col]; node != col; node=dlx->down[node] )
+	{
+		for ( other=dlx->right[node]; other != node; other=dlx->right[other] )
+		{
+			dlx->down[dlx->up[other]] = dlx->down[other];
+			dlx->up[dlx->down[other]] = dlx->up[other];
+			dlx->size[dlx->column[other]]--;
+			COUNTSTAT( dlx->stats, eliminations, 1 );
+		}
+	}
+}
+
+
+
+/*---UncoverColumn:	Links back column col and its rows, undoing CoverColumn (the nodes still hold their old links, so they are linked back in the reverse order they were unlinked)---*/
+static void UncoverColumn( DLX *dlx, int col )
+{
+	/*---Define variables in function UncoverColumn---*/
+	int node, other;								//Node of column col (node), and other node of its row (other)
+	
+	
+	
+	for ( node=dlx->up[col]; node != col; node=dlx->up[node] )
+	{
+		for ( other=dlx->left[node]; other != node; other=dlx->left[other] )
+		{
+			dlx->size[dlx->column[other]]++;
+			dlx->down[dlx->up[other]] = (unsigned short)other;
+			dlx->up[dlx->down[other]] = (unsigned short)other;
+		}
+	}
+	dlx->right[dlx->left[col]] = (unsigned short)col;
+	dlx->left[dlx->right[col]] = (unsigned short)col;
+}
+
+
+
+/*---SelectKernels:	Chooses the kernels called through the Kernels of a search state.  kernel is SUDOKUKERNELSCALAR, SUDOKUKERNELSSE42 or SUDOKUKERNELAVX2, or SUDOKUKERNELAUTO for the best instruction set the processor supports, checked at run time so the same program runs on any x86 processor (other processors always use the scalar kernels).  Returns the kernels, or NULL if kernel is unknown or not supported by the processor---*/
+static const Kernels *SelectKernels( int kernel )
+{
+	/*---Define variables in function SelectKernels---*/
+	int sse42 = 0, avx2 = 0;							//1 if the processor supports SSE4.2 (sse42) and AVX2 (avx2)
+	
+	
+	
+#ifdef X86KERNELS
+	__builtin_cpu_init();
+	sse42 = __builtin_cpu_supports( "sse4.2" );
+	avx2 = sse42 && __builtin_cpu_supports( "avx2" );
+#endif
+	if ( kernel == SUDOKUKERNELAUTO )
+		kernel = avx2 ? SUDOKUKERNELAVX2 : sse42 ? SUDOKUKERNELSSE42 : SUDOKUKERNELSCALAR;
+	
+	if ( kernel == SUDOKUKERNELSCALAR )
+		return &scalarkernels;
+#ifdef X86KERNELS
+	if ( kernel == SUDOKUKERNELSSE42 && sse42 )
+		return &sse42kernels;
+	if ( kernel == SUDOKUKERNELAVX2 && avx2 )
+		return &avx2kernels;
+#endif
+	
+	return NULL;
+}
+
+
+
+/*---GetWallTime:	Returns the current wall clock time in seconds---*/
+static double GetWallTime( void )
+{
+	/*---Define variables in function GetWallTime---*/
+	struct timespec ts;								//Current time, in seconds and nanoseconds
+	
+	
+	
+	timespec_get( &ts, TIME_UTC );
+	return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+
+
+
+/*---ScanCellsScalar:	Scans the candidate counts (ncand of a SearchState) of the 81 cells, one cell at a time.  Sets in scan the empty cells with 0 or 1 candidates (low), the fewest candidates of any empty cell (fewest), and the empty cells with that many candidates (best)---*/
+static void ScanCellsScalar( const unsigned char *ncand, CellScan *scan )
+{
+	/*---Define variables in function ScanCellsScalar---*/
+	int cell;									//Generic use cell of the Board
+	
+	
+	
+	memset( scan, 0, sizeof(*scan) );
+	scan->fewest = CELLFILLED;
+	for ( cell=0; cell<81; cell++ )
+	{
+		if ( ncand[cell] <= 1 )
+			scan->low[cell/32] |= 1u << (cell%32);
+		if ( ncand[cell] < scan->fewest )
+		{
+			scan->fewest = ncand[cell];
+			memset( scan->best, 0, sizeof(scan->best) );
+		}
+		if ( ncand[cell] == scan->fewest )
+			scan->best[cell/32] |= 1u << (cell%32);
+	}
+}
+
+
+
+#ifdef X86KERNELS
+/*---ScanCellsSSE42:	Same as ScanCellsScalar, 16 cells at a time.  The padding after cell 80 is CELLFILLED, so the 96 counts are loaded in 6 vectors, the minimum is found with unsigned byte minimums, and the cell bitmasks are built with byte compares and movemask---*/
+__attribute__((target("sse4.2")))
+static void ScanCellsSSE42( const unsigned char *ncand, CellScan *scan )
+{
+	/*---Define variables in function ScanCellsSSE42---*/
+	__m128i counts[6];								//Candidate counts of 16 cells in each vector
+	__m128i fewest = _mm_set1_epi8( (char)CELLFILLED ), one = _mm_set1_epi8( 1 );	//Minimum count (fewest), and 1 in every byte (one)
+	int ind;									//Generic use index in loops (ind)
+	
+	
+	
+	for ( ind=0; ind<6; ind++ )
+	{
+		counts[ind] = _mm_loadu_si128( (const __m128i *)(ncand + ind*16) );
+		fewest = _mm_min_epu8( fewest, counts[ind] );
+	}
+	fewest = _mm_min_epu8( fewest, _mm_srli_si128( fewest, 8 ) );			//Minimum across the 16 bytes
+	fewest = _mm_min_epu8( fewest, _mm_srli_si128( fewest, 4 ) );
+	fewest = _mm_min_epu8( fewest, _mm_srli_si128( fewest, 2 ) );
+	fewest = _mm_min_epu8( fewest, _mm_srli_si128( fewest, 1 ) );
+	scan->fewest = _mm_cvtsi128_si32( fewest ) & 0xFF;
+	fewest = _mm_set1_epi8( (char)scan->fewest );
+	
+	memset( scan->low, 0, sizeof(scan->low) );
+	memset( scan->best, 0, sizeof(scan->best) );
+	for ( ind=0; ind<6; ind++ )
+	{
+		scan->low[ind/2] |= (unsigned int)_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_min_epu8( counts[ind], one ), counts[ind] ) ) << (ind%2*16);
+		scan->best[ind/2] |= (unsigned int)_mm_movemask_epi8( _mm_cmpeq_epi8( counts[ind], fewest ) ) << (ind%2*16);
+	}
+	scan->best[2] &= 0x1FFFF;							//Only cells 64-80 of the last word, not the padding
+}
+
+
+
+/*---ScanCellsAVX2:	Same as ScanCellsSSE42, 32 cells at a time, so each word of the cell bitmasks is one movemask---*/
+__attribute__((target("avx2")))
+static void ScanCellsAVX2( const unsigned char *ncand, CellScan *scan )
+{
+	/*---Define variables in function ScanCellsAVX2---*/
+	__m256i counts[3];								//Candidate counts of 32 cells in each vector
+	__m256i fewest = _mm256_set1_epi8( (char)CELLFILLED ), one = _mm256_set1_epi8( 1 );	//Minimum count (fewest), and 1 in every byte (one)
+	__m128i half;									//Minimum count, folded to 128 bits
+	int ind;									//Generic use index in loops (ind)
+	
+	
+	
+	for ( ind=0; ind<3; ind++ )
+	{
+		counts[ind] = _mm256_loadu_si256( (const __m256i *)(ncand + ind*32) );
+		fewest = _mm256_min_epu8( fewest, counts[ind] );
+	}
+	half = _mm_min_epu8( _mm256_castsi256_si128( fewest ), _mm256_extracti128_si256( fewest, 1 ) );	//Minimum across the 32 bytes
+	half = _mm_min_epu8( half, _mm_srli_si128( half, 8 ) );
+	half = _mm_min_epu8( half, _mm_srli_si128( half, 4 ) );
+	half = _mm_min_epu8( half, _mm_srli_si128( half, 2 ) );
+	half = _mm_min_epu8( half, _mm_srli_si128( half, 1 ) );
+	scan->fewest = _mm_cvtsi128_si32( half ) & 0xFF;
+	fewest = _mm256_set1_epi8( (char)scan->fewest );
+	
+	for ( ind=0; ind<3; ind++ )
+	{
+		scan->low[ind] = (unsigned int)_mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_min_epu8( counts[ind], one ), counts[ind] ) );
+		scan->best[ind] = (unsigned int)_mm256_movemask_epi8( _mm256_cmpeq_epi8( counts[ind], fewest ) );
+	}
+	scan->best[2] &= 0x1FFFF;							//Only cells 64-80 of the last word, not the padding
+}
+#endif
+
+
+
+/*---ComputeCandidatesScalar:	Computes the candidates (cand) and candidate count (ncand) of every cell of the search state from the row, column and region bitmasks, one cell at a time.  A filled cell gets no candidates and a count of CELLFILLED---*/
+static void ComputeCandidatesScalar( SearchState *state )
+{
+	/*---Define variables in function ComputeCandidatesScalar---*/
+	int cell;									//Generic use cell of the Board
+	
+	
+	
+	for ( cell=0; cell<81; cell++ )
+	{
+		if ( state->board.cell[cell] == 0 )
+		{
+			state->cand[cell] = (unsigned short)( ~(state->masks.row[cellrow[cell]] | state->masks.col[cellcol[cell]] | state->masks.reg[cellreg[cell]]) & 0x1FF );
+			state->ncand[cell] = (unsigned char)__builtin_popcount( state->cand[cell] );
+		}
+		else
+		{
+			state->cand[cell] = 0;
+			state->ncand[cell] = CELLFILLED;
+		}
+	}
+}
+
+
+
+#ifdef X86KERNELS
+/*---ComputeCandidatesSSE42:	Same as ComputeCandidatesScalar, with the row, column and region bitmasks of 8 cells of a row in the 16-bit lanes of a vector (the 9th cell of the row is done alone).  The candidate counts are a popcount by nibble lookup (pshufb)---*/
+__attribute__((target("sse4.2")))
+static void ComputeCandidatesSSE42( SearchState *state )
+{
+	/*---Define variables in function ComputeCandidatesSSE42---*/
+	const __m128i all = _mm_set1_epi16( 0x1FF ), nibble = _mm_set1_epi8( 0x0F ), bytelow = _mm_set1_epi16( 0xFF );	//All 9 values (all), and masks of the low nibble (nibble) and low byte (bytelow) of each lane
+	const __m128i bitcount = _mm_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );	//Number of bits set in each nibble 0-15
+	const __m128i filled = _mm_set1_epi8( (char)CELLFILLED );
+	__m128i cols = _mm_loadu_si128( (const __m128i *)state->masks.col );		//Column bitmasks of columns 0-7
+	__m128i regs, used, empty, cand, counts;					//Region bitmasks (regs), digits used (used), empty cells (empty), candidates (cand) and candidate counts (counts) of 8 cells
+	const unsigned short *reg;							//Bitmasks of the 3 regions crossing the row
+	int row, cell;									//Row of the Board (row), and 9th cell of the row (cell)
+	
+	
+	
+	for ( row=0; row<9; row++ )
+	{
+		reg = state->masks.reg + (row/3)*3;
+		regs = _mm_setr_epi16( (short)reg[0], (short)reg[0], (short)reg[0], (short)reg[1], (short)reg[1], (short)reg[1], (short)reg[2], (short)reg[2] );
+		used = _mm_or_si128( _mm_or_si128( _mm_set1_epi16( (short)state->masks.row[row] ), cols ), regs );
+		empty = _mm_cmpeq_epi16( _mm_cvtepu8_epi16( _mm_loadl_epi64( (const __m128i *)(state->board.cell + row*9) ) ), _mm_setzero_si128() );
+		cand = _mm_and_si128( _mm_andnot_si128( used, all ), empty );
+		_mm_storeu_si128( (__m128i *)(state->cand + row*9), cand );
+		
+		counts = _mm_add_epi8( _mm_shuffle_epi8( bitcount, _mm_and_si128( cand, nibble ) ), _mm_shuffle_epi8( bitcount, _mm_and_si128( _mm_srli_epi16( cand, 4 ), nibble ) ) );
+		counts = _mm_add_epi16( _mm_and_si128( counts, bytelow ), _mm_srli_epi16( counts, 8 ) );
+		counts = _mm_blendv_epi8( filled, _mm_packus_epi16( counts, counts ), _mm_packs_epi16( empty, empty ) );
+		_mm_storel_epi64( (__m128i *)(state->ncand + row*9), counts );
+		
+		cell = row*9 + 8;
+		if ( state->board.cell[cell] == 0 )
+		{
+			state->cand[cell] = (unsigned short)( ~(state->masks.row[row] | state->masks.col[8] | reg[2]) & 0x1FF );
+			state->ncand[cell] = (unsigned char)__builtin_popcount( state->cand[cell] );
+		}
+		else
+		{
+			state->cand[cell] = 0;
+			state->ncand[cell] = CELLFILLED;
+		}
+	}
+}
+#endif
@@ -0,0 +1,141 @@
+#ifndef SUDOKU_H
+#define SUDOKU_H
+
+/*---Sudoku solver library, the solving engines of SudokuSolver as functions that can be called from any program
+	Every function is reentrant:  it works only on the buffers the caller passes in and on its own stack, so any number of threads can call it at once.  No function prints anything, reads any input, exits the program, or allocates memory (except SudokuSolveSplit, which starts threads, SudokuSolveBig, which keeps the search stack of a 16x16 or 25x25 puzzle on the heap, and the cache of solved puzzles, which is shared by any threads under its own lock).  Each function returns one of the status codes below
+	A puzzle is an array of dim*dim bytes in row-major order (cell = row*dim + col), 0 for an empty cell or a value 1 to dim.  dim is 9 except for SudokuSolveBig.  The solution may be written to the same array as the puzzle
+	Build with the Makefile (targets libsudoku.a and libsudoku.so), or compile Sudoku.c, SudokuCache.c and SudokuGrade.c along with the program (SudokuBig.h must be in the same folder), and link with -pthread.  The functions have C linkage, also when the header is included from C++
+---*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+/*---Status codes returned by the functions---*/
+#define SUDOKUOK 0									//Solved, or exactly one solution (SudokuCount), or a valid puzzle (SudokuValidate)
+#define SUDOKUUNSOLVABLE 1								//The puzzle has no solution
+#define SUDOKUMULTIPLE 2								//The puzzle has more than one solution (SudokuCount)
+#define SUDOKUINVALID 3									//A value is out of range, or is repeated in a row, column or region
+#define SUDOKUUNSUPPORTED 4								//An option or argument is not supported (unknown engine, kernels the processor does not support, size other than 9, 16 or 25, limit below 1)
+#define SUDOKUNOMEMORY 5								//Memory could not be allocated (SudokuSolveSplit, SudokuSolveBig)
+#define SUDOKUABORTED 6									//The search was stopped before it finished, by a budget or the cancel flag of SudokuOptions (the stats hold the search so far)
+#define SUDOKUFILEERROR 7								//A cache file cannot be read or written, or is not a cache file (SudokuCacheLoad, SudokuCacheSave)
+
+/*---Solving engines (SudokuOptions engine)---*/
+#define SUDOKUENGINEPROPAGATE 0								//Constraint propagation and guessing the most constrained cell (the default)
+#define SUDOKUENGINEDLX 1								//Exact cover with Knuth's Dancing Links
+
+/*---Kernels used by the propagate engine to compute and scan the candidates of the cells (SudokuOptions kernel)---*/
+#define SUDOKUKERNELAUTO 0								//The best the processor supports (the default)
+#define SUDOKUKERNELSCALAR 1								//Plain C, any processor
+#define SUDOKUKERNELSSE42 2								//SSE4.2 instructions
+#define SUDOKUKERNELAVX2 3								//AVX2 instructions
+
+/*---Techniques of the ladder of the grader, from the easiest to the hardest (SudokuGrading technique, and the index of uses)---*/
+#define SUDOKUTECHNONE 0								//No technique, the puzzle has no empty cell
+#define SUDOKUTECHHIDDENSINGLE 1							//A value that can only go in one cell of a row, column or region
+#define SUDOKUTECHNAKEDSINGLE 2								//A cell with only one candidate left
+#define SUDOKUTECHLOCKED 3								//Locked candidates, a value of a region locked to one row or column (pointing), or of a row or column locked to one region (claiming)
+#define SUDOKUTECHPAIR 4								//Naked or hidden pair, 2 cells of a unit with only 2 candidates between them, or 2 values that can only go in 2 cells of a unit
+#define SUDOKUTECHTRIPLE 5								//Naked or hidden triple, the same with 3 cells and 3 values
+#define SUDOKUTECHXWING 6								//X-Wing, a value that can only go in the same 2 columns of 2 rows, or the same 2 rows of 2 columns
+#define SUDOKUTECHSWORDFISH 7								//Swordfish, the same with 3 rows and 3 columns
+#define SUDOKUTECHCHAIN 8								//Chain, alternating strong and weak links between candidates, over one value (X-chain) or several (XY-chain)
+#define SUDOKUTECHSEARCH 9								//Search, the techniques are stuck and the rest of the puzzle needs guessing
+#define SUDOKUTECHNIQUES 10
+
+
+
+/*---Declaration of data types
+	SudokuOptions:	How a puzzle is solved, and the budgets of the search.  All zero (or a NULL pointer) is the propagate engine with the best kernels, and no limits
+	SudokuStats:	Counters of the search of one puzzle and the time it took, filled in when a pointer to one is passed (the counters stay 0 if the library was compiled with -DNOSTATS)
+	SudokuTransform:	A symmetry of Sudoku (transposing, reordering rows within bands, bands, columns within stacks and stacks, and relabeling the values), the one turning a puzzle into its canonical form, found by SudokuCanonicalize
+	SudokuCache:	Cache of solved puzzles keyed by canonical form, with the least recently used entries dropped when full (file SudokuCache.c, its fields are not part of the interface)
+	SudokuGrading:	Difficulty of a puzzle found by SudokuGrade, the hardest technique needed, its rating, and the steps taken with each technique
+---*/
+typedef struct SudokuOptions
+{
+	int engine;									//SUDOKUENGINEPROPAGATE or SUDOKUENGINEDLX
+	int kernel;									//SUDOKUKERNELAUTO, SUDOKUKERNELSCALAR, SUDOKUKERNELSSE42 or SUDOKUKERNELAVX2
+	long maxnodes;									//Most nodes of the search tree visited before the search is aborted, 0 for no limit
+	double maxseconds;								//Most wall clock seconds the search may take before it is aborted, 0 for no limit (checked every few hundred nodes)
+	long maxmemory;									//Most bytes of search state, 0 for no limit:  the search is aborted when it would go deeper in its guessing than the copies of its state that fit (one per level, about 430 bytes for 9x9, 1 KB for 16x16 and 4 KB for 25x25), or when the exact cover matrix of the DLX engine (about 33 KB) does not fit.  The 9x9 search always reserves its stack of 82 levels (about 35 KB of C stack), so for 9x9 this caps the depth of guessing rather than the memory used.  The stack of a 16x16 or 25x25 search is allocated as it grows, never beyond maxmemory
+	const int *cancel;								//Flag set to nonzero by any thread to abort the search, NULL for none
+} SudokuOptions;
+
+typedef struct SudokuStats
+{
+	long nodes;									//Nodes of the search tree visited
+	long backtracks;								//Guesses undone because they led to a dead end
+	long propagations;								//Values placed by naked and hidden singles, and candidates removed by locked candidates (0 for the DLX engine)
+	long eliminations;								//Candidates removed from the peers of the cells filled in, for the DLX engine nodes unlinked from the exact cover matrix
+	int maxdepth;									//Deepest level of guessing reached, 0 if the puzzle was solved without guessing (for the DLX engine, most rows chosen by the search at once)
+	double seconds;									//Wall clock time taken by the puzzle
+} SudokuStats;
+
+typedef struct SudokuTransform
+{
+	int transpose;									//1 if rows and columns of the puzzle are swapped first
+	unsigned char row[9];								//Row of the puzzle (column if transposed) each row of the canonical form comes from
+	unsigned char col[9];								//Column of the puzzle (row if transposed) each column of the canonical form comes from
+	unsigned char digit[10];							//Value of the canonical form each value of the puzzle is relabeled to, digit[0] is 0 (an empty cell)
+} SudokuTransform;
+
+typedef struct SudokuCache SudokuCache;
+
+typedef struct SudokuGrading
+{
+	int technique;									//Hardest technique needed, a SUDOKUTECH code
+	double rating;									//Rating of the hardest step, 1.5 for a hidden single up to 4.6 for a swordfish, 5.0 to 8.8 for a chain by its length, and 9 plus the deepest level of guessing when search is needed (the higher the harder)
+	int steps;									//Deductions made by the techniques (values placed by singles, and subsets, fish and chains that removed candidates)
+	int uses[SUDOKUTECHNIQUES];							//Deductions made by each technique, uses[SUDOKUTECHSEARCH] is 1 if search was needed
+	int longestchain;								//Strong links of the longest chain used, 0 if none
+	int empty;									//Empty cells left when the techniques got stuck, 0 if they solved the puzzle
+	long searchnodes;								//Nodes of the search tree visited solving the rest of the puzzle, 0 if not needed (and if the library was compiled with -DNOSTATS)
+	int searchdepth;								//Deepest level of guessing of that search
+} SudokuGrading;
+
+
+
+/*---Declaration of functions
+	SudokuSolve:	Solves a 9x9 puzzle, the solution is written to solution.  Returns SUDOKUOK, SUDOKUUNSOLVABLE, SUDOKUINVALID, SUDOKUUNSUPPORTED or SUDOKUABORTED (solution is then unchanged)
+	SudokuCount:	Counts the solutions of a 9x9 puzzle, stopping at limit, the number found is written to count and the first solution to solution (unless NULL).  Returns SUDOKUOK (one solution), SUDOKUUNSOLVABLE, SUDOKUMULTIPLE, SUDOKUINVALID, SUDOKUUNSUPPORTED or SUDOKUABORTED (count is then the solutions found so far)
+	SudokuValidate:	Checks that a 9x9 puzzle has only values 0-9 and no value repeated in a row, column or region.  Returns SUDOKUOK or SUDOKUINVALID (the puzzle may still have no solution)
+	SudokuSolveBig:	Solves a puzzle of size dim (9, 16 or 25) with the propagate engine, within the budgets of options.  The search stack of a 16x16 or 25x25 puzzle is allocated on the heap as the search goes deeper (never beyond the memory budget), so the C stack use is small at any depth.  Returns the same as SudokuSolve, or SUDOKUNOMEMORY
+	SudokuSolveSplit:	Same as SudokuSolve, with the search split over numthreads threads (propagate engine only).  Allocates memory and starts threads for the call.  Returns the same as SudokuSolve, or SUDOKUNOMEMORY
+	SudokuCheckOptions:	Checks that the engine and kernels of options are known and supported by the processor.  Returns SUDOKUOK or SUDOKUUNSUPPORTED
+	SudokuCanonicalize:	Finds the canonical form of a 9x9 puzzle, the same for every puzzle equivalent to it under the symmetries of Sudoku, written to canonical, and the symmetry turning the puzzle into it, written to transform (unless NULL).  Returns SUDOKUOK or SUDOKUINVALID (a value above 9)
+	SudokuApplyTransform:	Turns a board of a puzzle (e.g. its solution) into the board of its canonical form, written to out, through the symmetry of the puzzle found by SudokuCanonicalize
+	SudokuUndoTransform:	Turns a board of the canonical form (e.g. its solution) back into the board of the puzzle, written to out, undoing SudokuApplyTransform
+	SudokuCacheCreate:	Allocates an empty cache of at most capacity solved puzzles.  Returns the cache, or NULL if capacity is less than 1 or memory could not be allocated
+	SudokuCacheFree:	Frees a cache (no other thread may be using it)
+	SudokuCacheSolve:	Same as SudokuSolve, but a puzzle equivalent to one already in the cache is answered from it without searching (the counters of stats are then 0), and the solution of a puzzle solved is added to it.  Puzzles with fewer than 10 empty cells, and very symmetric ones whose canonical form takes long to find, are solved without the cache.  Any number of threads may share a cache.  Returns the same as SudokuSolve
+	SudokuCacheCounts:	Gets the number of entries of a cache, and of the puzzles answered from it (hits) and solved because they were not in it (misses), each unless NULL
+	SudokuCacheLoad:	Adds the entries of a cache file written by SudokuCacheSave to a cache (a file that does not exist is an empty cache).  Returns SUDOKUOK or SUDOKUFILEERROR
+	SudokuCacheSave:	Writes the entries of a cache to a compact binary cache file (52 bytes per entry).  Returns SUDOKUOK or SUDOKUFILEERROR
+	SudokuGrade:	Grades the difficulty of a 9x9 puzzle by solving it with a ladder of human techniques, the easiest that makes progress at each step, written to grade.  grade is cleared first, so it is all zeros if the puzzle is not graded.  If the techniques get stuck, the rest is solved by search (SudokuSolve with options), counted in grade.  The solution is written to solution (unless NULL).  Returns SUDOKUOK, SUDOKUUNSOLVABLE, SUDOKUINVALID, SUDOKUUNSUPPORTED or SUDOKUABORTED
+---*/
+int SudokuSolve( const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options, SudokuStats *stats );
+int SudokuCount( const unsigned char *puzzle, int limit, int *count, unsigned char *solution, const SudokuOptions *options, SudokuStats *stats );
+int SudokuValidate( const unsigned char *puzzle );
+int SudokuSolveBig( int dim, const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options );
+int SudokuSolveSplit( const unsigned char *puzzle, unsigned char *solution, int numthreads, const SudokuOptions *options );
+int SudokuCheckOptions( const SudokuOptions *options );
+int SudokuCanonicalize( const unsigned char *puzzle, unsigned char *canonical, SudokuTransform *transform );
+void SudokuApplyTransform( const SudokuTransform *transform, const unsigned char *board, unsigned char *out );
+void SudokuUndoTransform( const SudokuTransform *transform, const unsigned char *canonical, unsigned char *out );
+SudokuCache *SudokuCacheCreate( long capacity );
+void SudokuCacheFree( SudokuCache *cache );
+int SudokuCacheSolve( SudokuCache *cache, const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options, SudokuStats *stats );
+void SudokuCacheCounts( SudokuCache *cache, long *entries, long *hits, long *misses );
+int SudokuCacheLoad( SudokuCache *cache, const char *filename );
+int SudokuCacheSave( SudokuCache *cache, const char *filename );
+int SudokuGrade( const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options, SudokuGrading *grade );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
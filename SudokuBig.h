@@ -0,0 +1,409 @@
+/*---Solver for BIGDIM x BIGDIM Sudoku puzzles (regions of BIGREG x BIGREG cells, values 1 to BIGDIM), for Sudoku.c
+	This file is a template, Sudoku.c includes it once for each board size with BIGDIM and BIGREG defined, e.g.
+		#define BIGDIM 16
+		#define BIGREG 4
+		#include "SudokuBig.h"
+	and each inclusion defines its own data type, index tables and functions, with the size appended to their names (e.g. SolveBig16, BigState16).  So each size gets bitmasks only as wide as it needs (16 bits up to 16x16, 32 bits above), index tables of its own size, and constant loop bounds the compiler can unroll, the same as if the solver had been written out for that size.  The 9x9 solver in Sudoku.c does not go through here at all, so it loses no speed to the larger sizes.
+	The solution method is the same as the 9x9 solver (functions AnalyzeCell, Propagate, SelectCell and Change):  naked and hidden singles are filled in, then the empty cell with the fewest candidates is guessed on a copy of the search state, in one loop over an explicit stack like the 9x9 solver.  Unlike the 9x9 solver the stack is not a fixed array on the C stack, since a stack for every level of a 25x25 puzzle (626 copies of a 4 KB state) would take 2.5 MB whatever the depth reached, more than the C stack of many threads.  It is allocated on the heap for BIGSTACKLEVELS levels and doubled as the search goes deeper, never beyond the memory budget, so it only takes the levels reached and the C stack use is the same at any depth
+---*/
+
+#ifndef BIGPASTE
+#define BIGPASTE(name,dim) BIGPASTE2(name,dim)
+#define BIGPASTE2(name,dim) name##dim
+#define BIGSTACKLEVELS 16								//Levels of the search stack allocated to start with, doubled when the search goes deeper
+#endif
+
+#define BIGNAME(name) BIGPASTE(name,BIGDIM)						//Name of a type, table or function for this size, e.g. BIGNAME(SolveBig) is SolveBig16
+#define BIGCELLS (BIGDIM*BIGDIM)							//Number of cells
+#define BIGUNITS (3*BIGDIM)								//Number of rows, columns and regions
+#define BIGPEERS (3*(BIGDIM-1) - 2*(BIGREG-1))						//Number of peers of each cell
+#if BIGDIM <= 16
+#define BIGMASK unsigned short								//Bitmask of values, bit val-1 for value val
+#else
+#define BIGMASK unsigned int
+#endif
+#define BIGALL ((BIGMASK)( ((unsigned long)1 << BIGDIM) - 1 ))				//Bitmask of all values
+
+
+
+/*---Declaration of data types
+	BigState:	State of the search for a solution, same as SearchState of the 9x9 solver.  Each level of the search works on its own copy
+	BigLevel:	One level of the search stack of AnalyzeBig, the copy of the search state at that level of guessing and the cell guessed there
+---*/
+typedef struct BIGNAME(BigState)
+{
+	unsigned char cell[BIGCELLS];							//Values of the cells, 0 for an empty cell
+	BIGMASK row[BIGDIM], col[BIGDIM], reg[BIGDIM];					//Bitmasks of the values placed in each row, column and region
+	BIGMASK cand[BIGCELLS];								//Bitmask of the values still possible in each empty cell (candidates), 0 for a filled cell
+	unsigned char ncand[BIGCELLS];							//Number of candidates of each cell, kept up to date with cand
+	int numempty;									//Number of empty cells left
+	int depth;									//Level of guessing of this copy of the state, 0 before the first guess
+	Budget *budget;									//Limits of the search, shared by every copy of the state, NULL if none
+} BIGNAME(BigState);
+
+typedef struct BIGNAME(BigLevel)
+{
+	BIGNAME(BigState) state;							//Copy of the search state at this level of guessing
+	BIGMASK cands;									//Candidates of the cell guessed at this level, not tried yet
+	int cell;									//Cell guessed at this level
+} BIGNAME(BigLevel);
+
+
+
+/*---Index tables, built once by BuildBigTables
+	bigrow, bigcol, bigreg:	Row, column and region of each cell
+	bigunits:	Cells of each row (units 0 to BIGDIM-1), column (next BIGDIM units) and region (last BIGDIM units)
+	bigpeers:	The other cells in the same row, column or region as each cell
+---*/
+static unsigned char BIGNAME(bigrow)[BIGCELLS], BIGNAME(bigcol)[BIGCELLS], BIGNAME(bigreg)[BIGCELLS];
+static unsigned short BIGNAME(bigunits)[BIGUNITS][BIGDIM];
+static unsigned short BIGNAME(bigpeers)[BIGCELLS][BIGPEERS];
+static pthread_once_t BIGNAME(bigonce) = PTHREAD_ONCE_INIT;
+
+
+
+/*---Declaration of functions
+	SolveBig:	Solves a puzzle of this size, within the budgets of options.  Returns SUDOKUOK if solved, SUDOKUUNSOLVABLE if the puzzle has no solution, SUDOKUINVALID if a value is out of range or repeated, SUDOKUNOMEMORY if the search stack could not be allocated, SUDOKUABORTED if a budget ran out
+	BuildBigTables:	Builds the index tables of this size
+	InitBig:	Records the key values of the puzzle in a search state and computes the candidates of each empty cell.  Returns SUDOKUINVALID if a key value is out of range or repeated, SUDOKUUNSOLVABLE if a cell has no candidates, otherwise SUDOKUOK
+	AnalyzeBig:	Solves the puzzle from a search state by propagation and guessing, in one loop over a search stack of at most maxlevels levels allocated on the heap.  Returns SUDOKUOK if solved (the state holds the solution), SUDOKUUNSOLVABLE if there is no solution, SUDOKUNOMEMORY if the stack could not be allocated, SUDOKUABORTED if the search is stopped by its budget
+	PropagateBig:	Places every value that can be deduced by naked singles and hidden singles, until nothing changes.  Returns 0 if a dead end is found, otherwise 1
+	SelectBig:	Chooses the empty cell with the fewest candidates
+	ChangeBig:	Places a value in a cell and removes it from the candidates of the peers of the cell.  Returns 0 if a peer is left with no candidates, otherwise 1
+---*/
+static int BIGNAME(SolveBig)( const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options );
+static void BIGNAME(BuildBigTables)( void );
+static int BIGNAME(InitBig)( const unsigned char *puzzle, BIGNAME(BigState) *state );
+static int BIGNAME(AnalyzeBig)( BIGNAME(BigState) *state, int maxlevels );
+static int BIGNAME(PropagateBig)( BIGNAME(BigState) *state );
+static int BIGNAME(SelectBig)( const BIGNAME(BigState) *state );
+static int BIGNAME(ChangeBig)( BIGNAME(BigState) *state, int cell, int val );
+
+
+
+/*---SolveBig:	Solves a puzzle of this size (BIGCELLS values) by constraint propagation and guessing, within the budgets of options (NULL for no limits, the memory budget counts one BigLevel per level of the search stack, and the stack is never allocated beyond it).  Returns SUDOKUOK if the puzzle was solved (the solution is written to solution, which may be the same array as puzzle), SUDOKUUNSOLVABLE if it has no solution, SUDOKUINVALID if a value is out of range or repeated, SUDOKUNOMEMORY if the search stack could not be allocated, SUDOKUABORTED if a budget ran out or the search was cancelled first (solution is then unchanged)---*/
+static int BIGNAME(SolveBig)( const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options )
+{
+	/*---Define variables in function SolveBig---*/
+	BIGNAME(BigState) state;							//State of the search, starting from the key values of the puzzle
+	Budget budget;									//Limits of the search
+	int maxlevels;									//Most levels of the search stack, as many as the memory budget allows, at most one per empty cell and the state searched from
+	int status;									//Status returned
+	
+	
+	
+	pthread_once( &BIGNAME(bigonce), BIGNAME(BuildBigTables) );
+	
+	if ( (status = BIGNAME(InitBig)( puzzle, &state )) != SUDOKUOK )
+		return status;
+	if ( InitBudget( options, sizeof(BIGNAME(BigLevel)), sizeof(BIGNAME(BigLevel)), &budget ) )
+		state.budget = &budget;
+	maxlevels = budget.maxdepth < BIGCELLS ? budget.maxdepth + 1 : BIGCELLS + 1;
+	if ( (status = BIGNAME(AnalyzeBig)( &state, maxlevels )) != SUDOKUOK )
+		return status;
+	
+	memcpy( solution, state.cell, BIGCELLS );
+	return SUDOKUOK;
+}
+
+
+
+/*---BuildBigTables:	Builds the index tables of this size (bigrow, bigcol, bigreg, bigunits and bigpeers).  Called once through pthread_once---*/
+static void BIGNAME(BuildBigTables)( void )
+{
+	/*---Define variables in function BuildBigTables---*/
+	int cell, other, ind, unit, numpeers;						//Generic use cell (cell) and other cell (other), index (ind), unit (unit), and number of peers found so far (numpeers)
+	
+	
+	
+	for ( cell=0; cell<BIGCELLS; cell++ )
+	{
+		BIGNAME(bigrow)[cell] = (unsigned char)( cell/BIGDIM );
+		BIGNAME(bigcol)[cell] = (unsigned char)( cell%BIGDIM );
+		BIGNAME(bigreg)[cell] = (unsigned char)( (cell/BIGDIM/BIGREG)*BIGREG + (cell%BIGDIM)/BIGREG );
+	}
+	
+	for ( unit=0; unit<BIGDIM; unit++ )
+	{
+		for ( ind=0; ind<BIGDIM; ind++ )
+		{
+			BIGNAME(bigunits)[unit][ind] = (unsigned short)( unit*BIGDIM + ind );
+			BIGNAME(bigunits)[BIGDIM+unit][ind] = (unsigned short)( ind*BIGDIM + unit );
+			BIGNAME(bigunits)[2*BIGDIM+unit][ind] = (unsigned short)( ((unit/BIGREG)*BIGREG + ind/BIGREG)*BIGDIM + (unit%BIGREG)*BIGREG + ind%BIGREG );
+		}
+	}
+	
+	for ( cell=0; cell<BIGCELLS; cell++ )
+	{
+		numpeers = 0;
+		for ( other=0; other<BIGCELLS; other++ )
+		{
+			if ( other != cell && (BIGNAME(bigrow)[other] == BIGNAME(bigrow)[cell] || BIGNAME(bigcol)[other] == BIGNAME(bigcol)[cell] || BIGNAME(bigreg)[other] == BIGNAME(bigreg)[cell]) )
+				BIGNAME(bigpeers)[cell][numpeers++] = (unsigned short)other;
+		}
+	}
+}
+
+
+
+/*---InitBig:	Records the initial (key) values of the puzzle in the search state, and computes the candidates of each empty cell.  Returns SUDOKUINVALID if a key value is out of range or repeated in a row, column or region, SUDOKUUNSOLVABLE if an empty cell has no candidates (the puzzle has no solution), otherwise SUDOKUOK---*/
+static int BIGNAME(InitBig)( const unsigned char *puzzle, BIGNAME(BigState) *state )
+{
+	/*---Define variables in function InitBig---*/
+	BIGMASK bit, used;								//Bit of a value (bit), and values used in the row, column and region of a cell (used)
+	int cell, val;									//Generic use cell (cell), and value of a cell (val)
+	
+	
+	
+	memset( state, 0, sizeof(*state) );
+	for ( cell=0; cell<BIGCELLS; cell++ )
+	{
+		val = puzzle[cell];
+		state->cell[cell] = (unsigned char)val;
+		if ( val == 0 )
+		{
+			state->numempty++;
+			continue;
+		}
+		if ( val > BIGDIM )
+			return SUDOKUINVALID;
+		bit = (BIGMASK)( (BIGMASK)1 << (val-1) );
+		if ( (state->row[BIGNAME(bigrow)[cell]] | state->col[BIGNAME(bigcol)[cell]] | state->reg[BIGNAME(bigreg)[cell]]) & bit )
+			return SUDOKUINVALID;
+		state->row[BIGNAME(bigrow)[cell]] |= bit;
+		state->col[BIGNAME(bigcol)[cell]] |= bit;
+		state->reg[BIGNAME(bigreg)[cell]] |= bit;
+	}
+	
+	for ( cell=0; cell<BIGCELLS; cell++ )
+	{
+		if ( state->cell[cell] == 0 )
+		{
+			used = state->row[BIGNAME(bigrow)[cell]] | state->col[BIGNAME(bigcol)[cell]] | state->reg[BIGNAME(bigreg)[cell]];
+			state->cand[cell] = (BIGMASK)( ~used & BIGALL );
+			state->ncand[cell] = (unsigned char)__builtin_popcount( state->cand[cell] );
+			if ( state->cand[cell] == 0 )
+				return SUDOKUUNSOLVABLE;
+		}
+	}
+	
+	return SUDOKUOK;
+}
+
+
+
+/*---AnalyzeBig:	Solves the puzzle from a search state, same as CountCell (stopping at the first solution), in one loop over a search stack allocated on the heap:  the node on top of the stack is searched first, PropagateBig places every value that can be deduced, then each candidate of the cell chosen by SelectBig is placed with ChangeBig on a copy of the state pushed on the stack, and a dead end is popped so the level before tries its next candidate.  The stack starts with BIGSTACKLEVELS levels and is doubled when full, up to maxlevels levels (the levels the memory budget allows), and going deeper than that aborts the search like the other budgets.  Each node is checked against the budget (unless NULL) with OutOfBudget.  Returns SUDOKUOK if the puzzle was solved (state then holds the solution), SUDOKUUNSOLVABLE if there is no solution from this state, SUDOKUNOMEMORY if the stack could not be allocated, SUDOKUABORTED if the search is stopped by its budget---*/
+static int BIGNAME(AnalyzeBig)( BIGNAME(BigState) *state, int maxlevels )
+{
+	/*---Define variables in function AnalyzeBig---*/
+	BIGNAME(BigLevel) *stack, *grown;						//Search stack, the copy of the state at each level of guessing and the cell guessed there (stack), and the stack after it is doubled (grown)
+	BIGNAME(BigState) *node;							//State of the node on top of the stack
+	int size = BIGSTACKLEVELS < maxlevels ? BIGSTACKLEVELS : ( maxlevels > 1 ? maxlevels : 1 );	//Levels allocated in the stack
+	int top = 0, done, val;								//Level on top of the stack (top), 1 if the node on top of the stack is finished with (done), and value being tried (val)
+	
+	
+	
+	if ( (stack = (BIGNAME(BigLevel) *)malloc( size*sizeof(BIGNAME(BigLevel)) )) == NULL )
+		return SUDOKUNOMEMORY;
+	stack[0].state = *state;
+	for ( ;; )
+	{
+		/*---Search the node on top of the stack:  it is finished with if it is a dead end, the search ends if it is a solution, otherwise the cell to guess at its level is chosen---*/
+		node = &stack[top].state;
+		if ( node->budget != NULL && OutOfBudget( node->budget, node->depth ) )	//Budget ran out, stop searching
+		{
+			free( stack );
+			return SUDOKUABORTED;
+		}
+		done = 1;
+		if ( BIGNAME(PropagateBig)( node ) )					//Otherwise a dead end, no solution from here
+		{
+			if ( node->numempty == 0 )					//All cells are filled in, the puzzle is solved
+			{
+				*state = *node;
+				free( stack );
+				return SUDOKUOK;
+			}
+			stack[top].cell = BIGNAME(SelectBig)( node );
+			stack[top].cands = node->cand[stack[top].cell];
+			done = 0;
+		}
+		
+		/*---Pop the levels finished with, until a level has a candidate left to try, then push a copy of its state with the candidate placed---*/
+		for ( ;; )
+		{
+			if ( done )
+			{
+				if ( top == 0 )						//Tried every candidate of every level, the puzzle has no solution
+				{
+					free( stack );
+					return SUDOKUUNSOLVABLE;
+				}
+				top--;
+			}
+			if ( stack[top].cands == 0 )					//Tried all candidates for this cell, there is a problem further back
+			{
+				done = 1;
+				continue;
+			}
+			
+			/*---Double the stack when it is full, up to the levels the memory budget allows (beyond them, the push is over budget)---*/
+			if ( top+1 == size )
+			{
+				if ( size >= maxlevels )
+				{
+					OutOfBudget( stack[top].state.budget, top+1 );	//Marks the search aborted, top+1 is deeper than the memory budget allows
+					free( stack );
+					return SUDOKUABORTED;
+				}
+				size = 2*size < maxlevels ? 2*size : maxlevels;
+				if ( (grown = (BIGNAME(BigLevel) *)realloc( stack, size*sizeof(BIGNAME(BigLevel)) )) == NULL )
+				{
+					free( stack );
+					return SUDOKUNOMEMORY;
+				}
+				stack = grown;
+			}
+			
+			val = __builtin_ctz( stack[top].cands ) + 1;			//Lowest value first
+			stack[top].cands &= (BIGMASK)( stack[top].cands - 1 );
+			stack[top+1].state = stack[top].state;
+			top++;
+			stack[top].state.depth++;
+			if ( BIGNAME(ChangeBig)( &stack[top].state, stack[top-1].cell, val ) )
+				break;							//Search the new node
+			done = 1;							//Dead end at once, pop it
+		}
+	}
+}
+
+
+
+/*---PropagateBig:	Constraint propagation, same as Propagate without locked candidates:  places naked singles and hidden singles, and repeats until nothing changes.  Returns 0 if a dead end is found (an empty cell with no candidates, or a value with no possible cell in a row, column or region), otherwise 1---*/
+static int BIGNAME(PropagateBig)( BIGNAME(BigState) *state )
+{
+	/*---Define variables in function PropagateBig---*/
+	BIGMASK once, twice, placed, hidden, bit, c;					//Candidates found at least once (once) and at least twice (twice) in a unit, values placed in the unit (placed), values with one possible cell (hidden), generic use bit (bit) and candidates (c)
+	int changed, cell, unit, ind;							//1 if anything changed this pass (changed), generic use cell (cell), unit (unit) and index (ind)
+	
+	
+	
+	do
+	{
+		changed = 0;
+		
+		/*---Naked singles---*/
+		for ( cell=0; cell<BIGCELLS; cell++ )
+		{
+			if ( state->cell[cell] == 0 && state->ncand[cell] <= 1 )
+			{
+				if ( state->ncand[cell] == 0 || !BIGNAME(ChangeBig)( state, cell, __builtin_ctz( state->cand[cell] ) + 1 ) )
+					return 0;
+				changed = 1;
+			}
+		}
+		
+		/*---Hidden singles, in the rows, then the columns, then the regions---*/
+		for ( unit=0; unit<BIGUNITS; unit++ )
+		{
+			once = twice = 0;
+			for ( ind=0; ind<BIGDIM; ind++ )
+			{
+				c = state->cand[BIGNAME(bigunits)[unit][ind]];
+				twice |= once & c;
+				once |= c;
+			}
+			placed = unit < BIGDIM ? state->row[unit] : unit < 2*BIGDIM ? state->col[unit-BIGDIM] : state->reg[unit-2*BIGDIM];
+			if ( (once | placed) != BIGALL )					//A value has no possible cell in this unit
+				return 0;
+			
+			hidden = once & (BIGMASK)~twice;
+			while ( hidden )
+			{
+				bit = hidden & (BIGMASK)( -hidden );
+				hidden &= (BIGMASK)~bit;
+				for ( ind=0; ind<BIGDIM; ind++ )
+				{
+					cell = BIGNAME(bigunits)[unit][ind];
+					if ( state->cand[cell] & bit )
+					{
+						if ( !BIGNAME(ChangeBig)( state, cell, __builtin_ctz( bit ) + 1 ) )
+							return 0;
+						changed = 1;
+						break;
+					}
+				}
+			}
+		}
+	}
+	while ( changed && state->numempty > 0 );
+	
+	return 1;
+}
+
+
+
+/*---SelectBig:	Chooses the empty cell to guess next, the one with the fewest candidates (the first one in row-major order if there is a tie)---*/
+static int BIGNAME(SelectBig)( const BIGNAME(BigState) *state )
+{
+	/*---Define variables in function SelectBig---*/
+	int cell, best = -1, fewest = BIGDIM+1;						//Generic use cell (cell), cell chosen so far (best), and its number of candidates (fewest)
+	
+	
+	
+	for ( cell=0; cell<BIGCELLS && fewest > 2; cell++ )				//2 is the best possible, Propagate fills in naked singles
+	{
+		if ( state->cell[cell] == 0 && state->ncand[cell] < fewest )
+		{
+			fewest = state->ncand[cell];
+			best = cell;
+		}
+	}
+	
+	return best;
+}
+
+
+
+/*---ChangeBig:	Places value val in the cell, records it in the row, column and region bitmasks, and removes it from the candidates of the peers of the cell.  Returns 0 if an empty peer is left with no candidates (a dead end), otherwise 1---*/
+static int BIGNAME(ChangeBig)( BIGNAME(BigState) *state, int cell, int val )
+{
+	/*---Define variables in function ChangeBig---*/
+	BIGMASK bit = (BIGMASK)( (BIGMASK)1 << (val-1) );				//Bit representing the value placed in the cell
+	int ind, peer;									//Generic use index (ind), and peer of the cell (peer)
+	
+	
+	
+	state->cell[cell] = (unsigned char)val;
+	state->cand[cell] = 0;
+	state->ncand[cell] = 0;
+	state->numempty--;
+	state->row[BIGNAME(bigrow)[cell]] |= bit;
+	state->col[BIGNAME(bigcol)[cell]] |= bit;
+	state->reg[BIGNAME(bigreg)[cell]] |= bit;
+	
+	for ( ind=0; ind<BIGPEERS; ind++ )
+	{
+		peer = BIGNAME(bigpeers)[cell][ind];
+		if ( state->cand[peer] & bit )
+		{
+			state->cand[peer] &= (BIGMASK)~bit;
+			if ( --state->ncand[peer] == 0 )
+				return 0;
+		}
+	}
+	
+	return 1;
+}
+
+
+
+/*---End of the template, so it can be included again for another size---*/
+#undef BIGNAME
+#undef BIGCELLS
+#undef BIGUNITS
+#undef BIGPEERS
+#undef BIGMASK
+#undef BIGALL
+#undef BIGDIM
+#undef BIGREG
@@ -0,0 +1,729 @@
+#include <stdio.h>								//Standard I/O functions header file, for reading and writing cache files
+#include <string.h>								//Manipulate strings and arrays of characters functions header file, like memcpy
+#include <stdlib.h>								//General functions header file, like malloc
+#include <errno.h>								//Error codes header file, like ENOENT
+#include <time.h>								//Date and time functions header file, for timing the search (SudokuStats)
+#include <pthread.h>								//POSIX threads functions header file, for sharing a cache between threads
+#include "Sudoku.h"								//The functions this library offers, status codes and options
+
+/*---Sudoku solver library, canonical form of 9x9 puzzles and the cache of solved puzzles (see Sudoku.h for the functions it offers)---*/
+
+
+/*---Highlights of the canonical form and the cache
+	1)  Two puzzles are equivalent if one is turned into the other by the symmetries of Sudoku, which keep every solution a solution:  relabeling the values, reordering the 3 bands (groups of 3 rows) and the 3 rows within each band, the same for the stacks (groups of 3 columns) and their columns, and transposing.  Equivalent puzzles need the same search, so only one of them has to be solved
+	2)  The canonical form of a puzzle is the smallest of all its equivalent puzzles:  first the one with the smallest pattern of cells given, read row by row with a given cell smaller than an empty one (so the values are packed to the top and left), then among those the smallest read cell by cell in row-major order, with the values relabeled in order of first appearance (so the first value is always 1, the next different one 2, and so on).  Equivalent puzzles have the same canonical form
+	3)  The canonical form is found without trying every symmetry (3,359,232 reorderings of rows and columns), by choosing the rows one at a time and keeping only the partial symmetries that give the smallest pattern so far (function SudokuCanonicalize).  The columns are not chosen one by one but narrowed down:  the columns of each stack are kept in cells of columns with the same pattern so far, in any order, and each row splits the cells into the columns given first and the empty ones after (function SplitCells).  So only ties between rows are tried, usually a handful of partial symmetries, and a puzzle takes about a thousand cell reads
+	4)  The cache (data type SudokuCache) maps the canonical form of a puzzle to the solution of the canonical form, in a hash table with chaining, and keeps its entries in a list from the most to the least recently used, so a full cache drops the entry used longest ago (LRU).  A puzzle equivalent to one solved before is answered by mapping the cached solution back through its symmetry (function SudokuCacheSolve)
+	5)  A cache can be saved to a binary file and loaded back, each entry in 52 bytes:  the cells that are given in the canonical form as 81 bits, and the solution as 4 bits per cell (the canonical form is the solution at the given cells)
+---*/
+
+
+
+
+
+
+/*---Declaration of data types
+	CanonState:	A partial symmetry of the puzzle while its canonical form is being found, the rows chosen so far and the columns narrowed down to cells
+	CacheEntry:	One solved puzzle in the cache, its canonical form and the solution of the canonical form, linked in its chain of the hash table and in the list of most recently used entries
+	SudokuCache:	The cache of solved puzzles (declared in Sudoku.h without its fields), the entries, the hash table and the list of most recently used entries, shared by any number of threads under its lock
+---*/
+typedef struct CanonState
+{
+	unsigned char transpose;							//1 if rows and columns of the puzzle are swapped
+	unsigned char row[9];								//Row of the puzzle (transposed if transpose is 1) each row of the canonical form comes from, the ones chosen so far
+	unsigned char numcells;								//Number of cells of columns
+	unsigned short cell[9];								//Columns of the puzzle (as bits) in each cell of columns, in the order of the canonical form:  a cell holds the columns of a stack with the same pattern in every row so far, whose order is not chosen yet
+} CanonState;
+
+#define BITS2(n) n, n+1, n+1, n+2						//Bits set in each of 4, 16, 64 or 256 numbers in a row (BITS2 to BITS8), starting at a multiple of that count whose higher bits have n bits set (the table of RowPattern)
+#define BITS4(n) BITS2(n), BITS2(n+1), BITS2(n+1), BITS2(n+2)
+#define BITS6(n) BITS4(n), BITS4(n+1), BITS4(n+1), BITS4(n+2)
+#define BITS8(n) BITS6(n), BITS6(n+1), BITS6(n+1), BITS6(n+2)
+
+#define CANONSTATES 256									//Most partial symmetries kept while finding the canonical form.  Only very symmetric puzzles (almost full or almost empty grids, or a few values in a regular pattern) tie in more, and then the ties past CANONSTATES are dropped, so the form found may not be the smallest and equivalent puzzles may get different forms (SudokuCacheSolve does not cache these puzzles at all)
+#define CANONBOARDS 64									//Most boards SudokuCacheSolve relabels in step 2 of the canonical form, a puzzle needing more is solved without the cache (the puzzles of a few dozen values or more need 1 to 4, only very symmetric ones reach thousands, 55296 for a full grid)
+#define CACHEMINEMPTY 10								//Fewest empty cells of a puzzle SudokuCacheSolve looks up in the cache, one with fewer is solved at once by propagation, faster than its canonical form is found
+
+typedef struct CacheEntry
+{
+	unsigned char key[81];								//Canonical form of the puzzle
+	unsigned char solution[81];							//Solution of the canonical form
+	unsigned long long hash;							//Hash of key
+	long chain;									//Next entry in the same bucket of the hash table, -1 for none
+	long newer, older;								//Previous and next entry in the list of most recently used entries, -1 for none
+} CacheEntry;
+
+struct SudokuCache
+{
+	pthread_mutex_t lock;								//Lock protecting everything below, held for lookups and insertions only (never while solving)
+	CacheEntry *entries;								//The entries, capacity of them
+	long *buckets;									//First entry of each bucket of the hash table, -1 for none
+	long capacity, numentries, numbuckets;						//Most entries, entries used, and buckets of the hash table (a power of 2, at least capacity)
+	long newest, oldest;								//Most and least recently used entries, -1 if the cache is empty
+	long hits, misses;								//Puzzles answered from the cache, and puzzles solved by SudokuCacheSolve (not in the cache, or not looked up)
+};
+
+#define CACHEMAGIC "SDKCACH1"								//First 8 bytes of a cache file, with the format version
+#define CACHERECORD 52									//Bytes of each entry of a cache file, 11 for the cells given in the canonical form and 41 for the solution
+
+
+
+/*---Declaration of functions (the functions of Sudoku.h, then the ones used only in this file)
+	SudokuCanonicalize:	Finds the canonical form of a puzzle and the symmetry that turns the puzzle into it.  Returns SUDOKUOK or SUDOKUINVALID
+	SudokuApplyTransform:	Turns a board (e.g. a solution) of the puzzle into the board of the canonical form, through the symmetry found by SudokuCanonicalize
+	SudokuUndoTransform:	Turns a board of the canonical form back into the board of the puzzle, undoing SudokuApplyTransform
+	SudokuCacheCreate:	Allocates an empty cache of solved puzzles.  Returns the cache, or NULL if memory could not be allocated
+	SudokuCacheFree:	Frees a cache
+	SudokuCacheSolve:	Solves a puzzle from the cache if an equivalent puzzle is in it, otherwise with SudokuSolve, adding the solution to the cache.  Returns the same as SudokuSolve
+	SudokuCacheCounts:	Gets the entries, hits and misses of a cache
+	SudokuCacheLoad:	Adds the entries of a cache file to a cache.  Returns SUDOKUOK or SUDOKUFILEERROR
+	SudokuCacheSave:	Writes the entries of a cache to a cache file.  Returns SUDOKUOK or SUDOKUFILEERROR
+	FindCanonical:	Finds the canonical form of a puzzle and its symmetry, giving up on a very symmetric puzzle if the work is bounded.  Returns SUDOKUOK, SUDOKUINVALID or SUDOKUABORTED
+	RowChoices:	Lists the rows of the puzzle the next row of the canonical form can come from.  Returns the number of them
+	RowPattern:	Gets the pattern of a row of the puzzle through a partial symmetry.  Returns the pattern
+	SplitCells:	Splits the cells of columns of a partial symmetry into the columns with a value in a new row and the empty ones
+	RelabelBoard:	Writes the puzzle through a symmetry, with the values relabeled in order of first appearance, and sets the relabeling of the symmetry
+	FindEntry:	Looks up a canonical form in the hash table of a cache.  Returns the entry, or -1 if not found
+	InsertEntry:	Adds a canonical form and its solution to a cache as the most recently used entry, replacing the least recently used entry if the cache is full
+	TouchEntry:	Moves an entry to the front of the list of most recently used entries
+	HashBoard:	Returns the hash of a canonical form
+	GetWallTime:	Returns the current wall clock time in seconds
+---*/
+static int FindCanonical( const unsigned char *puzzle, unsigned char *canonical, SudokuTransform *transform, int maxboards );
+static int RowChoices( const unsigned char *chosen, int ind, unsigned char *choices );
+static int RowPattern( const CanonState *state, int rowgiven );
+static void SplitCells( CanonState *state, int rowgiven );
+static void RelabelBoard( const unsigned char *grid, SudokuTransform *transform, unsigned char *board );
+static long FindEntry( const SudokuCache *cache, const unsigned char *key, unsigned long long hash );
+static void InsertEntry( SudokuCache *cache, const unsigned char *key, const unsigned char *solution, unsigned long long hash );
+static void TouchEntry( SudokuCache *cache, long ind );
+static unsigned long long HashBoard( const unsigned char *key );
+static double GetWallTime( void );
+
+
+
+
+
+
+/*---SudokuCanonicalize:	Finds the canonical form of the 9x9 puzzle (see the highlights above) and writes it to canonical, and the symmetry that turns the puzzle into it to transform (unless NULL), with FindCanonical and no bound on its work.  Returns SUDOKUOK, or SUDOKUINVALID if a value is more than 9 (values repeated in a row, column or region are not checked)---*/
+int SudokuCanonicalize( const unsigned char *puzzle, unsigned char *canonical, SudokuTransform *transform )
+{
+	return FindCanonical( puzzle, canonical, transform, 0 );
+}
+
+
+
+/*---FindCanonical:	Finds the canonical form of the 9x9 puzzle (see the highlights above) and writes it to canonical, and the symmetry that turns the puzzle into it to transform (unless NULL), in two steps.  1) The pattern of the cells given is made the smallest, one row at a time:  every partial symmetry kept is extended with each row that can come next (function RowChoices, and for the first row whether to transpose and the order of the stacks), the pattern of the new row is read off the cells of columns (function RowPattern), and only the extensions giving the smallest row are kept (at most CANONSTATES of them), with their cells split by the new row (function SplitCells).  2) Each partial symmetry left is completed in every order of the columns still sharing a cell (but not the empty ones, which can stay in any order), the values are relabeled in order of first appearance (function RelabelBoard), and the smallest board is the canonical form.  If maxboards is more than 0 the work is bounded, for a very symmetric puzzle whose ties would take far longer than solving it:  the search gives up if the partial symmetries tied in step 1 do not fit in CANONSTATES, or before step 2 would relabel more than maxboards boards.  Returns SUDOKUOK, SUDOKUINVALID if a value is more than 9 (values repeated in a row, column or region are not checked), or SUDOKUABORTED if the search gave up (canonical and transform are then not set)---*/
+static int FindCanonical( const unsigned char *puzzle, unsigned char *canonical, SudokuTransform *transform, int maxboards )
+{
+	/*---Define variables in function FindCanonical---*/
+	static const unsigned char orders[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };	//The 6 orders of 3 stacks, or of the 3 columns of a cell
+	CanonState states[2][CANONSTATES];						//Partial symmetries kept (states[cur]), and their extensions by the next row (states[1-cur])
+	CanonState first;								//Partial symmetry with the first row not chosen yet, and the stacks in one order
+	SudokuTransform full, best;							//A partial symmetry completed in one order of its columns, and the one giving the smallest board
+	unsigned char grid[2][81];							//The puzzle, and the puzzle transposed
+	unsigned short given[2][9];							//Columns with a value in each row of the puzzle and of the puzzle transposed, as bits
+	unsigned short used[2] = { 0, 0 };						//Columns with a value in any row of the puzzle and of the puzzle transposed, as bits
+	unsigned char rows[9], board[81];						//Rows the next row can come from, and the board of a completed symmetry
+	unsigned char cellcol[9][3], cellsize[9];					//Columns and number of columns of each cell that is reordered in step 2
+	int order[9];									//Order chosen for each cell reordered in step 2, as an index in orders
+	int numstates = 1, numnext, cur = 0, numcells, found = 0;			//Number of partial symmetries kept, number of extensions kept, index in states of the partial symmetries kept, number of cells to reorder, and 1 once a board is found in step 2
+	int numboards = 0, numorders;							//Number of boards of step 2 so far, and of the orders of the cells of one partial symmetry
+	int row, ind, t, i, k, c, pos, numrows, key, bestkey;				//Row of the canonical form, generic use indexes (ind, t, i, k), column of the puzzle (c), column of the canonical form (pos), number of rows the row can come from, and pattern of the row (key) and the smallest one (bestkey)
+	const CanonState *state;							//Partial symmetry being extended
+	
+	
+	
+	memset( given, 0, sizeof(given) );
+	for ( pos=0; pos<81; pos++ )
+	{
+		if ( puzzle[pos] > 9 )
+			return SUDOKUINVALID;
+		grid[0][pos] = puzzle[pos];
+		grid[1][(pos%9)*9 + pos/9] = puzzle[pos];
+		if ( puzzle[pos] != 0 )
+		{
+			given[0][pos/9] |= (unsigned short)( 1 << (pos%9) );
+			given[1][pos%9] |= (unsigned short)( 1 << (pos/9) );
+		}
+	}
+	for ( i=0; i<9; i++ )
+	{
+		used[0] |= given[0][i];
+		used[1] |= given[1][i];
+	}
+	memset( &states[cur][0], 0, sizeof(CanonState) );
+	
+	
+	
+	/*---Step 1, make the pattern of the cells given the smallest, one row at a time---*/
+	for ( row=0; row<9; row++ )
+	{
+		numnext = 0;
+		bestkey = 1 << 9;
+		for ( ind=0; ind<numstates; ind++ )
+		{
+			numrows = RowChoices( states[cur][ind].row, row, rows );
+			for ( t=(row == 0 ? 0 : states[cur][ind].transpose); t<=(row == 0 ? 1 : states[cur][ind].transpose); t++ )
+			{
+				for ( i=0; i<numrows; i++ )
+				{
+					for ( k=0; k<(row == 0 ? 6 : 1); k++ )		//The first row also chooses the order of the stacks
+					{
+						state = &states[cur][ind];
+						if ( row == 0 )
+						{
+							first = *state;
+							first.transpose = (unsigned char)t;
+							first.numcells = 3;
+							for ( c=0; c<3; c++ )
+								first.cell[c] = (unsigned short)( 7 << (orders[k][c]*3) );
+							state = &first;
+						}
+						key = RowPattern( state, given[t][rows[i]] );
+						if ( key > bestkey )
+							continue;
+						if ( key < bestkey )
+						{
+							bestkey = key;
+							numnext = 0;
+						}
+						if ( numnext == CANONSTATES )
+						{
+							if ( maxboards > 0 )
+								return SUDOKUABORTED;			//Too many ties, the form would not be the smallest anyway
+							continue;
+						}
+						states[1-cur][numnext] = *state;
+						states[1-cur][numnext].row[row] = rows[i];
+						SplitCells( &states[1-cur][numnext++], given[t][rows[i]] );
+					}
+				}
+			}
+		}
+		numstates = numnext;
+		cur = 1-cur;
+	}
+	
+	
+	
+	/*---Step 2, complete each partial symmetry left in every order of its cells of more than one column (except empty columns), and keep the smallest board---*/
+	for ( ind=0; ind<numstates; ind++ )
+	{
+		state = &states[cur][ind];
+		full.transpose = state->transpose;
+		memcpy( full.row, state->row, 9 );
+		numcells = 0;
+		numorders = 1;
+		for ( i=0; i<state->numcells; i++ )
+		{
+			cellsize[numcells] = 0;
+			for ( c=0; c<9; c++ )
+				if ( state->cell[i] & (1 << c) )
+					cellcol[numcells][cellsize[numcells]++] = (unsigned char)c;
+			if ( cellsize[numcells] > 1 && (state->cell[i] & used[state->transpose]) )
+				numorders *= cellsize[numcells] == 2 ? 2 : 6;
+			order[numcells] = 0;
+			numcells++;
+		}
+		numboards += numorders;
+		if ( maxboards > 0 && numboards > maxboards )
+			return SUDOKUABORTED;
+		for ( ;; )
+		{
+			pos = 0;
+			for ( i=0; i<numcells; i++ )
+				for ( k=0; k<cellsize[i]; k++ )
+					full.col[pos++] = cellcol[i][cellsize[i] == 1 ? 0 : cellsize[i] == 2 ? order[i] ^ k : orders[order[i]][k]];
+			RelabelBoard( &grid[full.transpose][0], &full, board );
+			if ( !found || memcmp( board, canonical, 81 ) < 0 )
+			{
+				memcpy( canonical, board, 81 );
+				best = full;
+				found = 1;
+			}
+			for ( i=0; i<numcells; i++ )					//Next combination of the orders of the cells, leaving cells of one column or of empty columns in one order
+			{
+				if ( cellsize[i] == 1 || !(state->cell[i] & used[state->transpose]) )
+					continue;
+				if ( ++order[i] < (cellsize[i] == 2 ? 2 : 6) )
+					break;
+				order[i] = 0;
+			}
+			if ( i == numcells )
+				break;
+		}
+	}
+	
+	if ( transform != NULL )
+		*transform = best;
+	
+	return SUDOKUOK;
+}
+
+
+
+/*---RowPattern:	Gets the pattern of the row of the puzzle whose columns with a value are the bits of rowgiven, through the partial symmetry state:  in each cell of columns, those with a value come first.  Returns the pattern, 9 bits with the first column the highest and 1 for an empty cell, so a smaller pattern has its values further to the front---*/
+static int RowPattern( const CanonState *state, int rowgiven )
+{
+	/*---Define variables in function RowPattern---*/
+	static const unsigned char numbits[512] = { BITS8(0), BITS8(1) };		//Number of bits set in each set of columns (a table is faster than a popcount call where the processor has no popcount instruction)
+	int i, pos = 0, size, empty, key = 0;						//Cell, its first column, its number of columns and of empty columns in the row, and pattern of the row
+	
+	
+	
+	for ( i=0; i<state->numcells; i++ )
+	{
+		size = numbits[state->cell[i]];
+		empty = size - numbits[state->cell[i] & rowgiven];
+		key |= ( (1 << empty) - 1 ) << (9 - pos - size);
+		pos += size;
+	}
+	
+	return key;
+}
+
+
+
+/*---SplitCells:	Splits each cell of columns of the partial symmetry state into the columns with a value in the new row (the bits of rowgiven), which come first, and the empty ones---*/
+static void SplitCells( CanonState *state, int rowgiven )
+{
+	/*---Define variables in function SplitCells---*/
+	unsigned short cell[9];								//The cells after the split
+	int i, num = 0;									//Cell before the split, and number of cells after
+	
+	
+	
+	for ( i=0; i<state->numcells; i++ )
+	{
+		if ( state->cell[i] & rowgiven )
+			cell[num++] = (unsigned short)( state->cell[i] & rowgiven );
+		if ( state->cell[i] & ~rowgiven )
+			cell[num++] = (unsigned short)( state->cell[i] & ~rowgiven );
+	}
+	memcpy( state->cell, cell, num*sizeof(unsigned short) );
+	state->numcells = (unsigned char)num;
+}
+
+
+
+/*---RelabelBoard:	Writes to board the puzzle grid (transposed if the symmetry is) through the symmetry transform, with the values relabeled in order of first appearance, and sets the relabeling of transform (the values not in the puzzle relabeled last, in increasing order)---*/
+static void RelabelBoard( const unsigned char *grid, SudokuTransform *transform, unsigned char *board )
+{
+	/*---Define variables in function RelabelBoard---*/
+	int pos, val, nextlabel = 1;							//Cell of the board, value of the puzzle there, and label for the next value read
+	
+	
+	
+	memset( transform->digit, 0, 10 );
+	for ( pos=0; pos<81; pos++ )
+	{
+		val = grid[transform->row[pos/9]*9 + transform->col[pos%9]];
+		if ( val != 0 && transform->digit[val] == 0 )
+			transform->digit[val] = (unsigned char)nextlabel++;
+		board[pos] = transform->digit[val];
+	}
+	for ( val=1; val<=9; val++ )
+		if ( transform->digit[val] == 0 )
+			transform->digit[val] = (unsigned char)nextlabel++;
+}
+
+
+
+/*---RowChoices:	Lists in choices the rows of the puzzle that row ind of the canonical form can come from, given the rows chosen for rows 0 to ind-1 in chosen.  The first row of a band can come from any row of a band not used yet, and the other rows of a band from the rows left in the band of the row before.  Returns the number of rows listed---*/
+static int RowChoices( const unsigned char *chosen, int ind, unsigned char *choices )
+{
+	/*---Define variables in function RowChoices---*/
+	int k, prev, used = 0, num = 0;							//Row of the puzzle (k), generic use index (prev), bitmask of the bands used, or of the rows of the band used (used), and number of rows listed (num)
+	
+	
+	
+	if ( ind%3 == 0 )								//First row of a band, any row of a band not used yet
+	{
+		for ( prev=0; prev<ind; prev+=3 )
+			used |= 1 << (chosen[prev]/3);
+		for ( k=0; k<9; k++ )
+			if ( !(used & (1 << (k/3))) )
+				choices[num++] = (unsigned char)k;
+	}
+	else										//Another row of the band, any row of the band not used yet
+	{
+		for ( prev=ind - ind%3; prev<ind; prev++ )
+			used |= 1 << chosen[prev];
+		for ( k=(chosen[ind-1]/3)*3; k<(chosen[ind-1]/3)*3 + 3; k++ )
+			if ( !(used & (1 << k)) )
+				choices[num++] = (unsigned char)k;
+	}
+	
+	return num;
+}
+
+
+
+/*---SudokuApplyTransform:	Turns board, a board of the puzzle transform was found for (e.g. its solution), into the board of the canonical form, written to out (which must not be the same array as board):  each cell of the canonical form gets the value of the cell of the puzzle it comes from, relabeled---*/
+void SudokuApplyTransform( const SudokuTransform *transform, const unsigned char *board, unsigned char *out )
+{
+	/*---Define variables in function SudokuApplyTransform---*/
+	int row, col, src;								//Row and column of the canonical form, and cell of the puzzle it comes from
+	
+	
+	
+	for ( row=0; row<9; row++ )
+	{
+		for ( col=0; col<9; col++ )
+		{
+			src = transform->transpose ? transform->col[col]*9 + transform->row[row] : transform->row[row]*9 + transform->col[col];
+			out[row*9 + col] = transform->digit[board[src] <= 9 ? board[src] : 0];
+		}
+	}
+}
+
+
+
+/*---SudokuUndoTransform:	Turns canonical, a board of the canonical form (e.g. its solution), back into the board of the puzzle transform was found for, written to out (which must not be the same array as canonical), undoing SudokuApplyTransform---*/
+void SudokuUndoTransform( const SudokuTransform *transform, const unsigned char *canonical, unsigned char *out )
+{
+	/*---Define variables in function SudokuUndoTransform---*/
+	unsigned char value[10];							//Value of the puzzle each value of the canonical form comes from
+	int row, col, src, val;								//Row and column of the canonical form, cell of the puzzle it comes from, and generic use value
+	
+	
+	
+	memset( value, 0, sizeof(value) );
+	for ( val=1; val<=9; val++ )
+		value[transform->digit[val]] = (unsigned char)val;
+	for ( row=0; row<9; row++ )
+	{
+		for ( col=0; col<9; col++ )
+		{
+			src = transform->transpose ? transform->col[col]*9 + transform->row[row] : transform->row[row]*9 + transform->col[col];
+			out[src] = value[canonical[row*9 + col] <= 9 ? canonical[row*9 + col] : 0];
+		}
+	}
+}
+
+
+
+/*---SudokuCacheCreate:	Allocates an empty cache of at most capacity solved puzzles (about 200 bytes each), with a hash table of at least as many buckets.  Returns the cache, or NULL if capacity is less than 1 or memory could not be allocated---*/
+SudokuCache *SudokuCacheCreate( long capacity )
+{
+	/*---Define variables in function SudokuCacheCreate---*/
+	SudokuCache *cache;								//The new cache
+	long ind;									//Generic use index in loops
+	
+	
+	
+	if ( capacity < 1 || (cache = (SudokuCache *)calloc( 1, sizeof(SudokuCache) )) == NULL )
+		return NULL;
+	cache->capacity = capacity;
+	for ( cache->numbuckets=1; cache->numbuckets<capacity; cache->numbuckets*=2 )
+		;
+	cache->entries = (CacheEntry *)malloc( capacity*sizeof(CacheEntry) );
+	cache->buckets = (long *)malloc( cache->numbuckets*sizeof(long) );
+	if ( cache->entries == NULL || cache->buckets == NULL || pthread_mutex_init( &cache->lock, NULL ) != 0 )
+	{
+		free( cache->entries );
+		free( cache->buckets );
+		free( cache );
+		return NULL;
+	}
+	for ( ind=0; ind<cache->numbuckets; ind++ )
+		cache->buckets[ind] = -1;
+	cache->newest = cache->oldest = -1;
+	
+	return cache;
+}
+
+
+
+/*---SudokuCacheFree:	Frees the cache and its entries (nothing if cache is NULL).  No other thread may be using it---*/
+void SudokuCacheFree( SudokuCache *cache )
+{
+	if ( cache == NULL )
+		return;
+	pthread_mutex_destroy( &cache->lock );
+	free( cache->entries );
+	free( cache->buckets );
+	free( cache );
+}
+
+
+
+/*---SudokuCacheSolve:	Same as SudokuSolve, through the cache (SudokuSolve alone if cache is NULL).  The options are checked and the puzzle validated first, so neither depends on what is in the cache.  A puzzle with fewer than CACHEMINEMPTY empty cells, or too symmetric for its canonical form to be found within CANONBOARDS boards (function FindCanonical), is solved with SudokuSolve without the cache (a miss, not added), since finding its form would take longer than solving it.  Otherwise the canonical form of the puzzle is looked up in the cache:  if it is there, its solution is turned back through the symmetry of the puzzle (SudokuUndoTransform) and the search counters in stats are 0 (a hit).  Otherwise the puzzle is solved with SudokuSolve, with the options and counting the search in stats, and its solution is turned into the solution of the canonical form (SudokuApplyTransform) and added to the cache (a miss).  Only solved puzzles are added, so a puzzle with no solution or an aborted search is searched again each time.  The lock of the cache is not held while solving, so threads sharing a cache solve in parallel.  If the puzzle has more than one solution, a hit may give a different one than SudokuSolve would.  Returns the same as SudokuSolve---*/
+int SudokuCacheSolve( SudokuCache *cache, const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options, SudokuStats *stats )
+{
+	/*---Define variables in function SudokuCacheSolve---*/
+	SudokuTransform transform;							//Symmetry turning the puzzle into its canonical form
+	unsigned char key[81], canonsolution[81], board[81];				//Canonical form of the puzzle, its solution, and the solution of the puzzle
+	unsigned long long hash;							//Hash of the canonical form
+	long ind;									//Entry of the canonical form in the cache
+	int status, pos, numempty = 0;							//Status returned, cell of the puzzle, and number of empty cells
+	double start = stats != NULL ? GetWallTime() : 0.0;				//Wall clock time at start, if the search is timed
+	
+	
+	
+	if ( cache == NULL )
+		return SudokuSolve( puzzle, solution, options, stats );
+	if ( options != NULL && SudokuCheckOptions( options ) != SUDOKUOK )
+		return SudokuSolve( puzzle, solution, options, stats );		//Reports the options not supported the same way, whether the puzzle is in the cache or not
+	if ( SudokuValidate( puzzle ) != SUDOKUOK )
+		return SudokuSolve( puzzle, solution, options, stats );		//Reports the invalid puzzle the same way, before the work of its canonical form
+	for ( pos=0; pos<81; pos++ )
+		numempty += ( puzzle[pos] == 0 );
+	if ( numempty < CACHEMINEMPTY || FindCanonical( puzzle, key, &transform, CANONBOARDS ) != SUDOKUOK )
+	{
+		pthread_mutex_lock( &cache->lock );
+		cache->misses++;
+		pthread_mutex_unlock( &cache->lock );
+		return SudokuSolve( puzzle, solution, options, stats );		//Almost full, or too symmetric to find its canonical form quickly
+	}
+	hash = HashBoard( key );
+	
+	/*---Look up the canonical form, and answer from the cache if it is there---*/
+	pthread_mutex_lock( &cache->lock );
+	if ( (ind = FindEntry( cache, key, hash )) >= 0 )
+	{
+		memcpy( canonsolution, cache->entries[ind].solution, 81 );
+		TouchEntry( cache, ind );
+		cache->hits++;
+		pthread_mutex_unlock( &cache->lock );
+		SudokuUndoTransform( &transform, canonsolution, solution );
+		if ( stats != NULL )
+		{
+			memset( stats, 0, sizeof(*stats) );
+			stats->seconds = GetWallTime() - start;
+		}
+		return SUDOKUOK;
+	}
+	cache->misses++;
+	pthread_mutex_unlock( &cache->lock );
+	
+	/*---Not in the cache, solve the puzzle itself and add the solution of its canonical form---*/
+	status = SudokuSolve( puzzle, board, options, stats );
+	if ( status == SUDOKUOK )
+	{
+		SudokuApplyTransform( &transform, board, canonsolution );
+		pthread_mutex_lock( &cache->lock );
+		if ( FindEntry( cache, key, hash ) < 0 )				//Another thread may have added it meanwhile
+			InsertEntry( cache, key, canonsolution, hash );
+		pthread_mutex_unlock( &cache->lock );
+		memcpy( solution, board, 81 );
+	}
+	if ( stats != NULL )
+		stats->seconds = GetWallTime() - start;
+	
+	return status;
+}
+
+
+
+/*---SudokuCacheCounts:	Writes the number of entries in the cache, the puzzles answered from it (hits) and the puzzles solved by SudokuCacheSolve because they were not in it (misses) to entries, hits and misses (each unless NULL)---*/
+void SudokuCacheCounts( SudokuCache *cache, long *entries, long *hits, long *misses )
+{
+	pthread_mutex_lock( &cache->lock );
+	if ( entries != NULL )
+		*entries = cache->numentries;
+	if ( hits != NULL )
+		*hits = cache->hits;
+	if ( misses != NULL )
+		*misses = cache->misses;
+	pthread_mutex_unlock( &cache->lock );
+}
+
+
+
+/*---SudokuCacheLoad:	Adds the entries of the cache file filename (written by SudokuCacheSave) to the cache, in the order they were saved, least recently used first, so if the file holds more entries than the cache the most recently used ones are kept.  Each entry is checked, its solution must be a full grid with no value repeated, so a damaged file cannot give a wrong answer.  A file that does not exist is an empty cache.  Returns SUDOKUOK, or SUDOKUFILEERROR if the file cannot be read, is not a cache file, or has a damaged entry (the entries before it are added)---*/
+int SudokuCacheLoad( SudokuCache *cache, const char *filename )
+{
+	/*---Define variables in function SudokuCacheLoad---*/
+	FILE *fp;									//Cache file
+	unsigned char record[CACHERECORD];						//One entry of the file
+	unsigned char key[81], solution[81];						//Canonical form and its solution, unpacked from the entry
+	char magic[8];									//First bytes of the file
+	int cell, status = SUDOKUOK;							//Generic use cell of a Board, and status returned
+	size_t got;									//Bytes read
+	
+	
+	
+	if ( (fp = fopen( filename, "rb" )) == NULL )
+		return errno == ENOENT ? SUDOKUOK : SUDOKUFILEERROR;
+	if ( fread( magic, 1, 8, fp ) != 8 || memcmp( magic, CACHEMAGIC, 8 ) != 0 )
+	{
+		fclose( fp );
+		return SUDOKUFILEERROR;
+	}
+	
+	pthread_mutex_lock( &cache->lock );
+	while ( (got = fread( record, 1, CACHERECORD, fp )) == CACHERECORD )
+	{
+		for ( cell=0; cell<81; cell++ )
+		{
+			solution[cell] = (unsigned char)( (record[11 + cell/2] >> (4*(cell%2))) & 0xF );
+			if ( solution[cell] < 1 || solution[cell] > 9 )
+				break;
+			key[cell] = ( record[cell/8] >> (cell%8) ) & 1 ? solution[cell] : 0;
+		}
+		if ( cell < 81 || SudokuValidate( solution ) != SUDOKUOK )
+			break;
+		if ( FindEntry( cache, key, HashBoard( key ) ) < 0 )
+			InsertEntry( cache, key, solution, HashBoard( key ) );
+	}
+	pthread_mutex_unlock( &cache->lock );
+	if ( got != 0 || ferror( fp ) )							//A damaged or cut off entry, or a read error
+		status = SUDOKUFILEERROR;
+	fclose( fp );
+	
+	return status;
+}
+
+
+
+/*---SudokuCacheSave:	Writes the entries of the cache to the cache file filename, after CACHEMAGIC, from the least to the most recently used, each entry in CACHERECORD bytes:  the cells given in the canonical form as 81 bits (bit cell%8 of byte cell/8), then the solution as 4 bits per cell (the low 4 bits of byte 11 + cell/2 for an even cell, the high 4 bits for an odd cell).  Returns SUDOKUOK, or SUDOKUFILEERROR if the file cannot be written---*/
+int SudokuCacheSave( SudokuCache *cache, const char *filename )
+{
+	/*---Define variables in function SudokuCacheSave---*/
+	FILE *fp;									//Cache file
+	unsigned char record[CACHERECORD];						//One entry of the file
+	const CacheEntry *entry;							//Entry being written
+	long ind;									//Entry being written, in the list of most recently used entries
+	int cell, ok;									//Generic use cell of a Board, and 1 while everything is written
+	
+	
+	
+	if ( (fp = fopen( filename, "wb" )) == NULL )
+		return SUDOKUFILEERROR;
+	ok = fwrite( CACHEMAGIC, 1, 8, fp ) == 8;
+	
+	pthread_mutex_lock( &cache->lock );
+	for ( ind=cache->oldest; ind>=0 && ok; ind=cache->entries[ind].newer )
+	{
+		entry = &cache->entries[ind];
+		memset( record, 0, sizeof(record) );
+		for ( cell=0; cell<81; cell++ )
+		{
+			if ( entry->key[cell] != 0 )
+				record[cell/8] |= (unsigned char)( 1 << (cell%8) );
+			record[11 + cell/2] |= (unsigned char)( entry->solution[cell] << (4*(cell%2)) );
+		}
+		ok = fwrite( record, 1, CACHERECORD, fp ) == CACHERECORD;
+	}
+	pthread_mutex_unlock( &cache->lock );
+	
+	if ( fclose( fp ) != 0 )
+		ok = 0;
+	
+	return ok ? SUDOKUOK : SUDOKUFILEERROR;
+}
+
+
+
+/*---FindEntry:	Looks up the canonical form key, with hash hash, in its bucket of the hash table of the cache (the lock of the cache must be held).  Returns the entry, or -1 if it is not in the cache---*/
+static long FindEntry( const SudokuCache *cache, const unsigned char *key, unsigned long long hash )
+{
+	/*---Define variables in function FindEntry---*/
+	long ind;									//Entry in the chain of the bucket
+	
+	
+	
+	for ( ind=cache->buckets[hash & (cache->numbuckets-1)]; ind>=0; ind=cache->entries[ind].chain )
+		if ( cache->entries[ind].hash == hash && memcmp( cache->entries[ind].key, key, 81 ) == 0 )
+			return ind;
+	
+	return -1;
+}
+
+
+
+/*---InsertEntry:	Adds the canonical form key (not in the cache yet), with hash hash, and its solution to the cache as the most recently used entry (the lock of the cache must be held).  If the cache is full, the least recently used entry is unlinked from its bucket and from the list, and reused---*/
+static void InsertEntry( SudokuCache *cache, const unsigned char *key, const unsigned char *solution, unsigned long long hash )
+{
+	/*---Define variables in function InsertEntry---*/
+	CacheEntry *entry;								//The entry added
+	long ind, *link;								//Index of the entry added, and link in the chain of a bucket pointing to it
+	
+	
+	
+	if ( cache->numentries < cache->capacity )
+		ind = cache->numentries++;
+	else
+	{
+		/*---Full, drop the least recently used entry---*/
+		ind = cache->oldest;
+		for ( link=&cache->buckets[cache->entries[ind].hash & (cache->numbuckets-1)]; *link!=ind; link=&cache->entries[*link].chain )
+			;
+		*link = cache->entries[ind].chain;
+		cache->oldest = cache->entries[ind].newer;
+		if ( cache->oldest >= 0 )
+			cache->entries[cache->oldest].older = -1;
+		else
+			cache->newest = -1;
+	}
+	
+	entry = &cache->entries[ind];
+	memcpy( entry->key, key, 81 );
+	memcpy( entry->solution, solution, 81 );
+	entry->hash = hash;
+	entry->chain = cache->buckets[hash & (cache->numbuckets-1)];
+	cache->buckets[hash & (cache->numbuckets-1)] = ind;
+	entry->newer = -1;
+	entry->older = cache->newest;
+	if ( cache->newest >= 0 )
+		cache->entries[cache->newest].newer = ind;
+	else
+		cache->oldest = ind;
+	cache->newest = ind;
+}
+
+
+
+/*---TouchEntry:	Moves entry ind to the front of the list of most recently used entries of the cache (the lock of the cache must be held)---*/
+static void TouchEntry( SudokuCache *cache, long ind )
+{
+	/*---Define variables in function TouchEntry---*/
+	CacheEntry *entry = &cache->entries[ind];					//The entry moved
+	
+	
+	
+	if ( cache->newest == ind )
+		return;
+	cache->entries[entry->newer].older = entry->older;				//Not the newest, so it has a newer entry
+	if ( entry->older >= 0 )
+		cache->entries[entry->older].newer = entry->newer;
+	else
+		cache->oldest = entry->newer;
+	entry->older = cache->newest;
+	entry->newer = -1;
+	cache->entries[cache->newest].newer = ind;
+	cache->newest = ind;
+}
+
+
+
+/*---HashBoard:	Returns the hash of the 81 cells of the canonical form key (64-bit FNV-1a)---*/
+static unsigned long long HashBoard( const unsigned char *key )
+{
+	/*---Define variables in function HashBoard---*/
+	unsigned long long hash = 14695981039346656037ULL;				//FNV offset basis
+	int cell;									//Generic use cell of a Board
+	
+	
+	
+	for ( cell=0; cell<81; cell++ )
+		hash = ( hash ^ key[cell] ) * 1099511628211ULL;			//FNV prime
+	
+	return hash;
+}
+
+
+
+/*---GetWallTime:	Returns the current wall clock time in seconds---*/
+static double GetWallTime( void )
+{
+	/*---Define variables in function GetWallTime---*/
+	struct timespec ts;								//Current time, in seconds and nanoseconds
+	
+	
+	
+	timespec_get( &ts, TIME_UTC );
+	return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
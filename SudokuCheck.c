@@ -0,0 +1,122 @@
+#include <stdio.h>								//Standard input output functions header file, like printf
+#include <string.h>								//Manipulate strings and arrays of characters functions header file, like memcmp
+#include "Sudoku.h"								//The Sudoku solver library, the functions checked here
+
+
+
+/*---Example program of the Sudoku solver library, built and run by make check:  links libsudoku.a on its own (without SudokuSolver) and checks SudokuSolve, SudokuCount, SudokuValidate, SudokuGrade and SudokuCacheSolve on a few puzzles whose answers are known.  It compiles as C and as C++, so make check also checks that Sudoku.h links from C++.  Prints one line per failed check and a summary, and returns 0 if every check passed, 1 otherwise---*/
+
+
+
+/*---Puzzles checked, 81 values row by row, 0 for an empty cell
+	puzzle:		The puzzle in puzzles/input.csv, with exactly one solution
+	answer:		Its solution
+	fewer:		The puzzle with the values of its first row removed, it still has exactly one solution
+	many:		A puzzle of one row of values only, it has many solutions
+	repeated:	A value repeated in the first row, invalid
+	stuck:		A valid puzzle with no solution, the last cell of the first row has no value left
+---*/
+static const char *puzzle = "035290864082410703764380090218739040000804230043052970406571009359028417800900526";
+static const char *answer = "135297864982416753764385192218739645597864231643152978426571389359628417871943526";
+static const char *fewer = "000000000082410703764380090218739040000804230043052970406571009359028417800900526";
+static const char *many = "123456789000000000000000000000000000000000000000000000000000000000000000000000000";
+static const char *repeated = "110000000000000000000000000000000000000000000000000000000000000000000000000000000";
+static const char *stuck = "123456780000000009000000000000000000000000000000000000000000000000000000000000000";
+
+
+
+/*---Declaration of functions
+	ToGrid:		Converts a puzzle of 81 digits to an array of 81 values
+	Check:		Counts one check, printing an error if it failed.  Returns 1 if it passed, otherwise 0
+---*/
+void ToGrid( const char *digits, unsigned char *grid );
+int Check( int passed, const char *what );
+
+
+
+int main( void )
+{
+	/*---Define variables in function main---*/
+	unsigned char grid[81], solution[81], expected[81];				//Puzzle checked, solution found by the library, and solution expected
+	int count, passed = 0, total = 0;						//Number of solutions found by SudokuCount, and number of checks passed and made
+	SudokuGrading grade;								//Grade of a puzzle
+	SudokuOptions options;								//Options with an engine that does not exist
+	SudokuCache *cache;								//Cache of solved puzzles
+	
+	
+	
+	ToGrid( answer, expected );
+	
+	/*---SudokuValidate---*/
+	ToGrid( puzzle, grid );
+	passed += Check( SudokuValidate( grid ) == SUDOKUOK, "SudokuValidate of a valid puzzle" );
+	ToGrid( repeated, grid );
+	passed += Check( SudokuValidate( grid ) == SUDOKUINVALID, "SudokuValidate of a puzzle with a repeated value" );
+	total += 2;
+	
+	/*---SudokuSolve, also solving in place---*/
+	ToGrid( puzzle, grid );
+	passed += Check( SudokuSolve( grid, solution, NULL, NULL ) == SUDOKUOK && memcmp( solution, expected, 81 ) == 0, "SudokuSolve of puzzles/input.csv" );
+	ToGrid( fewer, grid );
+	passed += Check( SudokuSolve( grid, grid, NULL, NULL ) == SUDOKUOK && memcmp( grid, expected, 81 ) == 0, "SudokuSolve in place" );
+	ToGrid( stuck, grid );
+	passed += Check( SudokuSolve( grid, solution, NULL, NULL ) == SUDOKUUNSOLVABLE, "SudokuSolve of a puzzle with no solution" );
+	ToGrid( repeated, grid );
+	passed += Check( SudokuSolve( grid, solution, NULL, NULL ) == SUDOKUINVALID, "SudokuSolve of a puzzle with a repeated value" );
+	total += 4;
+	
+	/*---SudokuCount---*/
+	ToGrid( puzzle, grid );
+	passed += Check( SudokuCount( grid, 2, &count, solution, NULL, NULL ) == SUDOKUOK && count == 1 && memcmp( solution, expected, 81 ) == 0, "SudokuCount of a puzzle with one solution" );
+	ToGrid( many, grid );
+	passed += Check( SudokuCount( grid, 2, &count, NULL, NULL, NULL ) == SUDOKUMULTIPLE && count == 2, "SudokuCount of a puzzle with many solutions, up to 2" );
+	ToGrid( stuck, grid );
+	passed += Check( SudokuCount( grid, 2, &count, NULL, NULL, NULL ) == SUDOKUUNSOLVABLE && count == 0, "SudokuCount of a puzzle with no solution" );
+	total += 3;
+	
+	/*---SudokuGrade, an invalid puzzle graded after a valid one must not keep the grade of the valid one---*/
+	ToGrid( puzzle, grid );
+	passed += Check( SudokuGrade( grid, solution, NULL, &grade ) == SUDOKUOK && grade.technique != SUDOKUTECHNONE && grade.steps > 0 && memcmp( solution, expected, 81 ) == 0, "SudokuGrade of puzzles/input.csv" );
+	ToGrid( repeated, grid );
+	passed += Check( SudokuGrade( grid, NULL, NULL, &grade ) == SUDOKUINVALID && grade.technique == SUDOKUTECHNONE && grade.steps == 0 && grade.rating == 0.0, "SudokuGrade of a puzzle with a repeated value clears the grade" );
+	total += 2;
+	
+	/*---SudokuCacheSolve, a hit with options not supported must fail the same as a miss, and a very symmetric puzzle must still be solved---*/
+	memset( &options, 0, sizeof(options) );
+	options.engine = 99;
+	cache = SudokuCacheCreate( 10 );
+	ToGrid( puzzle, grid );
+	passed += Check( cache != NULL && SudokuCacheSolve( cache, grid, solution, NULL, NULL ) == SUDOKUOK && memcmp( solution, expected, 81 ) == 0, "SudokuCacheSolve of puzzles/input.csv" );
+	passed += Check( cache != NULL && SudokuCacheSolve( cache, grid, solution, &options, NULL ) == SUDOKUUNSUPPORTED, "SudokuCacheSolve of a cached puzzle with an unknown engine" );
+	ToGrid( many, grid );
+	passed += Check( cache != NULL && SudokuCacheSolve( cache, grid, solution, NULL, NULL ) == SUDOKUOK && SudokuValidate( solution ) == SUDOKUOK && memcmp( solution, grid, 9 ) == 0 && memchr( solution, 0, 81 ) == NULL, "SudokuCacheSolve of a very symmetric puzzle, solved without the cache" );
+	SudokuCacheFree( cache );
+	total += 3;
+	
+	printf( "%d of %d library checks passed\n", passed, total );
+	return passed == total ? 0 : 1;
+}
+
+
+
+/*---ToGrid:	Converts a puzzle of 81 digits (0 for an empty cell) to an array of 81 values---*/
+void ToGrid( const char *digits, unsigned char *grid )
+{
+	/*---Define variables in function ToGrid---*/
+	int cell;									//Generic use cell
+	
+	
+	
+	for ( cell=0; cell<81; cell++ )
+		grid[cell] = (unsigned char)( digits[cell] - '0' );
+}
+
+
+
+/*---Check:	Counts one check of the library, printing an error naming it (what) if it failed.  Returns 1 if it passed, otherwise 0---*/
+int Check( int passed, const char *what )
+{
+	if ( !passed )
+		fprintf( stderr, "ERROR - check failed:  %s\n", what );
+	return passed ? 1 : 0;
+}
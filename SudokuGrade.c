@@ -0,0 +1,691 @@
+#include <string.h>								//Manipulate strings and arrays of characters functions header file, like memcpy
+#include <pthread.h>								//POSIX threads functions header file, for building tables once
+#include "Sudoku.h"								//The functions this library offers, status codes and options
+
+/*---Sudoku solver library, the difficulty grader of 9x9 puzzles (see Sudoku.h for the functions it offers)---*/
+
+
+/*---Highlights of the grader
+	1)  A puzzle is graded by solving it the way a person would, with a ladder of logical techniques from the easiest to the hardest:  hidden singles, naked singles, locked candidates (pointing and claiming), pairs and triples (naked and hidden), X-Wing, swordfish, and chains.  At every step the easiest technique that makes progress is applied, and the ladder starts over from the top, so a harder technique is only used when every easier one is stuck (function SudokuGrade)
+	2)  The grade is the hardest technique needed and a rating, the rating of the hardest step:  from 1.5 for a hidden single to 4.6 for a swordfish (table techrating), and for a chain 5.0 plus 0.2 for each strong link after the first, up to 8.8.  If the techniques get stuck before the puzzle is solved, the rest is solved by search (SudokuSolve), and the rating is 9 plus the deepest level of guessing the search reached
+	3)  The candidates are tracked incrementally (data type GradeState):  placing a value or removing a candidate updates the candidates of the cell and, in each row, column and region, the cells each value can still go in, so every technique reads what it needs from bitmasks of 9 bits instead of scanning the grid again, and a contradiction (a cell with no candidate, or a value with no cell left in a unit) is noticed at once
+	4)  A chain (function Chains) is an alternating inference chain, over one value (X-chain) or several (XY-chain and mixed):  a strong link between two candidates means at least one is true (the only two places of a value in a unit, or the only two candidates of a cell), a weak link means at most one is (two places of a value that see each other, or two candidates of a cell).  Assuming a candidate false, a breadth-first search follows strong links to candidates that are then true and weak links to candidates that are then false, so the shortest chain is found first.  A candidate made false both ways (by the start being true, through a weak link, and by the start being false, through the chain) is removed.  A start made true by the chain is placed
+	5)  No memory is allocated and no state is kept between calls except tables built once and never changed after (through pthread_once), so any number of threads can grade puzzles at once
+---*/
+
+
+
+
+
+
+/*---Declaration of data types
+	GradeState:	State of the logical solution of a puzzle being graded, the values placed and the candidates left, kept both by cell and by unit
+---*/
+typedef struct GradeState
+{
+	unsigned char cell[81];								//Value of each cell, 0 for an empty cell
+	unsigned short cand[81];							//Bitmask of the values still possible in each empty cell (candidates, bit val-1 for val), 0 for a filled cell
+	unsigned short where[27][9];							//Cells of each unit each value can still go in, bit i for cell unitcells[unit][i], 0 once the value is placed in the unit
+	int numempty;									//Number of empty cells left
+	int broken;									//1 once a contradiction is found, a cell with no candidate or a value with no cell left in a unit (the puzzle has no solution)
+	int chainlength;								//Strong links of the chain applied by the last call of Chains
+} GradeState;
+
+#define CHAINNODES (81*9)								//Candidates a chain can go through, candidate cell*9 + val-1
+#define CHAINMAXLENGTH 255								//Most strong links of a chain
+#define CHAINRATING 5.0									//Rating of a chain of one strong link
+#define CHAINRATINGSTEP 0.2								//Rating added for each further strong link of a chain
+#define CHAINMAXRATING 8.8								//Highest rating of a chain, below any puzzle needing search
+#define SEARCHRATING 9.0								//Rating of a puzzle needing search, before its deepest level of guessing is added
+
+
+
+/*---Precomputed index tables for the 81 cells of a board, built once by BuildGradeTables
+	unitcells:	Cells of each row (units 0-8), column (units 9-17) and region (units 18-26)
+	cellunits:	Row, column and region unit of each cell
+	cellpos:	Place of each cell in each of its units, in the order of cellunits (the bit of the cell in where)
+	peers:		The 20 other cells in the same row, column or region as each cell
+	peermask:	The same peers as a set of cells, bit cell%64 of word cell/64
+	numbits:	Number of bits set in each bitmask of 9 bits (a table is faster than a popcount call where the processor has no popcount instruction)
+---*/
+static unsigned char unitcells[27][9];
+static unsigned char cellunits[81][3];
+static unsigned char cellpos[81][3];
+static unsigned char peers[81][20];
+static unsigned long long peermask[81][2];
+static unsigned char numbits[512];
+static pthread_once_t gradeonce = PTHREAD_ONCE_INIT;
+
+/*---Rating of a step of each technique (SUDOKUTECH codes), a chain is rated by its length instead---*/
+static const double techrating[SUDOKUTECHNIQUES] = { 0.0, 1.5, 2.3, 2.8, 3.2, 3.8, 4.2, 4.6, CHAINRATING, SEARCHRATING };
+
+
+
+/*---Declaration of functions (the function of Sudoku.h, then the ones used only in this file)
+	SudokuGrade:	Grades a puzzle by the hardest technique of the ladder needed to solve it, falling back to search when the techniques get stuck.  Returns SUDOKUOK, SUDOKUUNSOLVABLE, SUDOKUINVALID, SUDOKUUNSUPPORTED or SUDOKUABORTED
+	BuildGradeTables:	Builds the index tables of the cells
+	InitGrade:	Sets up the state of the grading of a puzzle, with every candidate, then places the values given
+	ApplyTechnique:	Applies one technique of the ladder everywhere in the grid.  Returns the number of deductions made
+	Place:		Places a value in a cell, and removes it from the candidates of the peers of the cell
+	Eliminate:	Removes a candidate from a cell
+	HiddenSingles:	Places each value that has only one cell left in a unit.  Returns the number of values placed
+	NakedSingles:	Places the value of each cell that has only one candidate left.  Returns the number of values placed
+	LockedCandidates:	Removes a value from a row or column when it is locked to it in a region (pointing), and from a region when it is locked to it in a row or column (claiming).  Returns the number of locked values that removed candidates
+	Subsets:	Removes candidates with the naked and hidden subsets of a size (pairs or triples) of each unit.  Returns the number of subsets that removed candidates
+	Fish:		Removes candidates with the fish of a size (X-Wing or swordfish) of each value.  Returns the number of fish that removed candidates
+	Chains:		Removes candidates (or places a value) with the shortest chain found.  Returns the number of candidates removed and values placed
+---*/
+static void BuildGradeTables( void );
+static void InitGrade( GradeState *state, const unsigned char *puzzle );
+static int ApplyTechnique( GradeState *state, int technique );
+static void Place( GradeState *state, int cell, int val );
+static void Eliminate( GradeState *state, int cell, int val );
+static int HiddenSingles( GradeState *state );
+static int NakedSingles( GradeState *state );
+static int LockedCandidates( GradeState *state );
+static int Subsets( GradeState *state, int size );
+static int Fish( GradeState *state, int size );
+static int Chains( GradeState *state );
+
+
+
+
+
+
+/*---SudokuGrade:	Grades the 9x9 puzzle (see the highlights above) and writes the grade to grade:  the techniques of the ladder are applied one step at a time, each step with the easiest technique that makes progress (function ApplyTechnique), until the puzzle is solved or every technique is stuck.  The rest of a stuck puzzle is solved by SudokuSolve with options, and its search is counted in grade.  The solution is written to solution (unless NULL).  A puzzle with more than one solution is graded by the way to one of them.  grade is cleared first, so it is all zeros (technique SUDOKUTECHNONE) if the puzzle is not graded at all.  Returns SUDOKUOK, SUDOKUUNSOLVABLE (a contradiction was found, grade holds the steps up to it), SUDOKUINVALID, SUDOKUUNSUPPORTED or SUDOKUABORTED (the search ran out of the budgets of options, grade holds its counters so far)---*/
+int SudokuGrade( const unsigned char *puzzle, unsigned char *solution, const SudokuOptions *options, SudokuGrading *grade )
+{
+	/*---Define variables in function SudokuGrade---*/
+	GradeState state;								//State of the logical solution of the puzzle
+	SudokuStats stats;								//Counters of the search of a stuck puzzle
+	unsigned char board[81];							//Solution found by the search
+	int technique, count, status;							//Technique of the step, deductions made by it, and return value of SudokuSolve
+	double rating;									//Rating of the step
+
+
+
+	memset( grade, 0, sizeof(SudokuGrading) );				//Cleared before any return, so an invalid puzzle gets an empty grade
+	if ( SudokuValidate( puzzle ) != SUDOKUOK )
+		return SUDOKUINVALID;
+	if ( options != NULL && SudokuCheckOptions( options ) != SUDOKUOK )
+		return SUDOKUUNSUPPORTED;
+	pthread_once( &gradeonce, BuildGradeTables );
+
+	InitGrade( &state, puzzle );
+
+	/*---One step at a time, the easiest technique that makes progress---*/
+	while ( state.numempty > 0 && !state.broken )
+	{
+		for ( technique=SUDOKUTECHHIDDENSINGLE; technique<SUDOKUTECHSEARCH; technique++ )
+			if ( (count = ApplyTechnique( &state, technique )) > 0 )
+				break;
+		if ( technique == SUDOKUTECHSEARCH )
+			break;
+
+		grade->uses[technique] += count;
+		grade->steps += count;
+		rating = techrating[technique];
+		if ( technique == SUDOKUTECHCHAIN )
+		{
+			rating = CHAINRATING + CHAINRATINGSTEP*(state.chainlength - 1);
+			if ( rating > CHAINMAXRATING )
+				rating = CHAINMAXRATING;
+			if ( state.chainlength > grade->longestchain )
+				grade->longestchain = state.chainlength;
+		}
+		if ( rating > grade->rating )
+			grade->rating = rating;
+		if ( technique > grade->technique )
+			grade->technique = technique;
+	}
+	if ( state.broken )
+		return SUDOKUUNSOLVABLE;
+
+	/*---Logic solved the puzzle---*/
+	if ( state.numempty == 0 )
+	{
+		if ( solution != NULL )
+			memcpy( solution, state.cell, 81 );
+		return SUDOKUOK;
+	}
+
+	/*---Logic is stuck, fall back to search from where it got to---*/
+	grade->empty = state.numempty;
+	status = SudokuSolve( state.cell, board, options, &stats );
+	grade->technique = SUDOKUTECHSEARCH;
+	grade->uses[SUDOKUTECHSEARCH] = 1;
+	grade->rating = SEARCHRATING + stats.maxdepth;
+	grade->searchnodes = stats.nodes;
+	grade->searchdepth = stats.maxdepth;
+	if ( status == SUDOKUOK && solution != NULL )
+		memcpy( solution, board, 81 );
+
+	return status;
+}
+
+
+
+/*---BuildGradeTables:	Builds unitcells, cellunits, cellpos, peers, peermask and numbits.  Called once through pthread_once---*/
+static void BuildGradeTables( void )
+{
+	/*---Define variables in function BuildGradeTables---*/
+	int unit, cell, other, ind, num;						//Unit, cell, another cell, generic use index (ind), and number of peers found (num)
+
+
+
+	for ( unit=0; unit<27; unit++ )
+		for ( ind=0; ind<9; ind++ )
+		{
+			if ( unit < 9 )
+				cell = unit*9 + ind;
+			else if ( unit < 18 )
+				cell = ind*9 + unit-9;
+			else
+				cell = ((unit-18)/3*3 + ind/3)*9 + (unit-18)%3*3 + ind%3;
+			unitcells[unit][ind] = (unsigned char)cell;
+			cellunits[cell][unit/9] = (unsigned char)unit;
+			cellpos[cell][unit/9] = (unsigned char)ind;
+		}
+
+	for ( cell=0; cell<81; cell++ )
+	{
+		num = 0;
+		for ( other=0; other<81; other++ )
+			if ( other != cell && (cellunits[other][0] == cellunits[cell][0] || cellunits[other][1] == cellunits[cell][1] || cellunits[other][2] == cellunits[cell][2]) )
+			{
+				peers[cell][num++] = (unsigned char)other;
+				peermask[cell][other/64] |= 1ULL << (other%64);
+			}
+	}
+
+	for ( ind=1; ind<512; ind++ )
+		numbits[ind] = (unsigned char)( numbits[ind/2] + (ind & 1) );
+}
+
+
+
+/*---InitGrade:	Sets up state for the puzzle, every cell empty with every candidate, then places the values given with Place (state is broken if an empty cell is left with no candidate)---*/
+static void InitGrade( GradeState *state, const unsigned char *puzzle )
+{
+	/*---Define variables in function InitGrade---*/
+	int cell, unit, val;								//Generic use cell, unit and value
+
+
+
+	memset( state->cell, 0, sizeof(state->cell) );
+	for ( cell=0; cell<81; cell++ )
+		state->cand[cell] = 0x1FF;
+	for ( unit=0; unit<27; unit++ )
+		for ( val=0; val<9; val++ )
+			state->where[unit][val] = 0x1FF;
+	state->numempty = 81;
+	state->broken = 0;
+	state->chainlength = 0;
+
+	for ( cell=0; cell<81; cell++ )
+		if ( puzzle[cell] != 0 )
+			Place( state, cell, puzzle[cell] );
+}
+
+
+
+/*---ApplyTechnique:	Applies the technique (a SUDOKUTECH code from SUDOKUTECHHIDDENSINGLE to SUDOKUTECHCHAIN) everywhere in the grid.  Returns the number of deductions made, 0 if the technique is stuck---*/
+static int ApplyTechnique( GradeState *state, int technique )
+{
+	switch ( technique )
+	{
+		case SUDOKUTECHHIDDENSINGLE:	return HiddenSingles( state );
+		case SUDOKUTECHNAKEDSINGLE:	return NakedSingles( state );
+		case SUDOKUTECHLOCKED:		return LockedCandidates( state );
+		case SUDOKUTECHPAIR:		return Subsets( state, 2 );
+		case SUDOKUTECHTRIPLE:		return Subsets( state, 3 );
+		case SUDOKUTECHXWING:		return Fish( state, 2 );
+		case SUDOKUTECHSWORDFISH:	return Fish( state, 3 );
+		case SUDOKUTECHCHAIN:		return Chains( state );
+	}
+
+	return 0;
+}
+
+
+
+/*---Place:	Places value val (1-9) in the empty cell:  the value is removed from the candidates of the peers of the cell (function Eliminate), then marked placed in the units of the cell, and the other candidates of the cell are removed from them.  If val is not a candidate of the cell, or a unit is left with a value that has no cell, state is broken---*/
+static void Place( GradeState *state, int cell, int val )
+{
+	/*---Define variables in function Place---*/
+	unsigned short bit = (unsigned short)( 1 << (val-1) );				//Bit of the value
+	unsigned short others = state->cand[cell] & ~bit;				//Other candidates of the cell
+	int ind, unit, other;								//Generic use index (ind), unit of the cell, and other candidate (0-8)
+
+
+
+	if ( !(state->cand[cell] & bit) )
+	{
+		state->broken = 1;
+		return;
+	}
+	state->cell[cell] = (unsigned char)val;
+	state->cand[cell] = 0;
+	state->numempty--;
+
+	for ( ind=0; ind<20; ind++ )
+		if ( state->cand[peers[cell][ind]] & bit )
+			Eliminate( state, peers[cell][ind], val );
+
+	/*---Only now is the value marked placed in the units of the cell, so removing it from the peers did not leave it with no cell---*/
+	for ( ind=0; ind<3; ind++ )
+	{
+		unit = cellunits[cell][ind];
+		state->where[unit][val-1] = 0;
+		for ( other=0; other<9; other++ )
+			if ( others & (1 << other) )
+			{
+				state->where[unit][other] &= (unsigned short)~(1 << cellpos[cell][ind]);
+				if ( state->where[unit][other] == 0 )
+					state->broken = 1;
+			}
+	}
+}
+
+
+
+/*---Eliminate:	Removes value val (1-9), which must be a candidate, from the candidates of the cell and from the cells it can go in of the units of the cell.  If the cell is left with no candidate, or a unit with no cell for the value, state is broken---*/
+static void Eliminate( GradeState *state, int cell, int val )
+{
+	/*---Define variables in function Eliminate---*/
+	int ind, unit;									//Generic use index (ind), and unit of the cell
+
+
+
+	state->cand[cell] &= (unsigned short)~(1 << (val-1));
+	if ( state->cand[cell] == 0 )
+		state->broken = 1;
+	for ( ind=0; ind<3; ind++ )
+	{
+		unit = cellunits[cell][ind];
+		state->where[unit][val-1] &= (unsigned short)~(1 << cellpos[cell][ind]);
+		if ( state->where[unit][val-1] == 0 )
+			state->broken = 1;
+	}
+}
+
+
+
+/*---HiddenSingles:	Places each value that can only go in one cell of a unit, in every unit, stopping at a contradiction.  Returns the number of values placed---*/
+static int HiddenSingles( GradeState *state )
+{
+	/*---Define variables in function HiddenSingles---*/
+	int unit, val, count = 0;							//Generic use unit and value (0-8), and number of values placed
+	unsigned short mask;								//Cells of the unit the value can go in
+
+
+
+	for ( unit=0; unit<27 && !state->broken; unit++ )
+		for ( val=0; val<9 && !state->broken; val++ )
+		{
+			mask = state->where[unit][val];
+			if ( mask != 0 && (mask & (mask-1)) == 0 )
+			{
+				Place( state, unitcells[unit][__builtin_ctz( mask )], val+1 );
+				count++;
+			}
+		}
+
+	return count;
+}
+
+
+
+/*---NakedSingles:	Places the only candidate of each cell that has one left, stopping at a contradiction.  Returns the number of values placed---*/
+static int NakedSingles( GradeState *state )
+{
+	/*---Define variables in function NakedSingles---*/
+	int cell, count = 0;								//Generic use cell, and number of values placed
+	unsigned short cand;								//Candidates of the cell
+
+
+
+	for ( cell=0; cell<81 && !state->broken; cell++ )
+	{
+		cand = state->cand[cell];
+		if ( cand != 0 && (cand & (cand-1)) == 0 )
+		{
+			Place( state, cell, __builtin_ctz( cand ) + 1 );
+			count++;
+		}
+	}
+
+	return count;
+}
+
+
+
+/*---LockedCandidates:	For each value and region, if the cells of the region the value can go in are all in one row or column, the value is removed from the rest of that row or column (pointing).  For each value and row or column, if its cells are all in one region, the value is removed from the rest of the region (claiming).  The cells of a row or column in each region it crosses, and the cells of a region in each of its rows and columns, are the same bits of where (table lines).  Returns the number of locked values that removed candidates---*/
+static int LockedCandidates( GradeState *state )
+{
+	/*---Define variables in function LockedCandidates---*/
+	static const unsigned short lines[6] = { 0x007, 0x038, 0x1C0, 0x049, 0x092, 0x124 };	//Cells of a region in each of its 3 rows and 3 columns, and of a row or column in each of the 3 regions it crosses (the first 3)
+	int unit, val, ind, line, cell, other, kind, removed, count = 0;		//Unit the value is locked in, value (0-8), generic use index (ind), unit the value is removed from (line), a cell the value can go in, a cell of line, kind of line (0 row, 1 column, 2 region), 1 once a candidate is removed, and number of locked values that removed candidates
+	unsigned short mask;								//Cells of the unit the value can go in
+
+
+
+	for ( unit=0; unit<27 && !state->broken; unit++ )
+		for ( val=0; val<9 && !state->broken; val++ )
+		{
+			mask = state->where[unit][val];
+			if ( mask == 0 )
+				continue;
+			for ( ind=0; ind<(unit < 18 ? 3 : 6); ind++ )
+				if ( (mask & ~lines[ind]) == 0 )
+					break;
+			if ( ind == (unit < 18 ? 3 : 6) )
+				continue;
+
+			/*---The line the value is locked to, and the kind of unit the value stays in (the unit it is locked in)---*/
+			cell = unitcells[unit][__builtin_ctz( mask )];
+			if ( unit < 18 )
+			{
+				line = cellunits[cell][2];
+				kind = unit/9;
+			}
+			else
+			{
+				line = cellunits[cell][ind < 3 ? 0 : 1];
+				kind = 2;
+			}
+
+			removed = 0;
+			for ( ind=0; ind<9; ind++ )
+			{
+				other = unitcells[line][ind];
+				if ( cellunits[other][kind] != unit && (state->cand[other] & (1 << val)) )
+				{
+					Eliminate( state, other, val+1 );
+					removed = 1;
+				}
+			}
+			count += removed;
+		}
+
+	return count;
+}
+
+
+
+/*---Subsets:	For each unit, finds the naked subsets of size cells (pairs or triples), size cells with only size candidates between them, which are removed from the other cells of the unit, and the hidden subsets, size values that can only go in size cells, whose other candidates are removed.  Both are found as size items (cells with their candidates, or values with their cells) whose bitmasks have size bits between them.  Returns the number of subsets that removed candidates---*/
+static int Subsets( GradeState *state, int size )
+{
+	/*---Define variables in function Subsets---*/
+	unsigned short mask[9];								//Bitmask of each item of the unit, the candidates of an empty cell (naked) or the cells of a value not placed (hidden)
+	unsigned char item[9];								//Index of each item, the place of the cell in the unit or the value (0-8)
+	int unit, hidden, num, i1, i2, i3, ind, cell, val, removed, count = 0;		//Generic use unit, 1 for hidden subsets, number of items, the items chosen (i1, i2 and i3, i3 equal to i2 for pairs), generic use index (ind), cell and value, 1 once a candidate is removed, and number of subsets that removed candidates
+	unsigned short items, bits;							//The items chosen as a bitmask, and their bitmasks together
+
+
+
+	for ( hidden=0; hidden<2; hidden++ )
+		for ( unit=0; unit<27 && !state->broken; unit++ )
+		{
+			num = 0;
+			for ( ind=0; ind<9; ind++ )
+			{
+				mask[num] = hidden ? state->where[unit][ind] : state->cand[unitcells[unit][ind]];
+				item[num] = (unsigned char)ind;
+				num += ( mask[num] != 0 );
+			}
+			if ( num <= size )
+				continue;
+
+			for ( i1=0; i1<num; i1++ )
+				for ( i2=i1+1; i2<num && numbits[mask[i1]] <= size; i2++ )
+				{
+					if ( numbits[mask[i1] | mask[i2]] > size )
+						continue;
+					for ( i3=(size == 3 ? i2+1 : i2); i3<(size == 3 ? num : i2+1); i3++ )
+					{
+						bits = mask[i1] | mask[i2] | mask[i3];
+						if ( numbits[bits] != size )
+							continue;
+						items = (unsigned short)( (1 << item[i1]) | (1 << item[i2]) | (1 << item[i3]) );
+
+						/*---Naked:  the candidates bits are removed from the cells not in items.  Hidden:  the candidates not in items are removed from the cells bits---*/
+						removed = 0;
+						for ( ind=0; ind<9; ind++ )
+						{
+							if ( (hidden ? bits : (unsigned short)~items) & (1 << ind) )
+							{
+								cell = unitcells[unit][ind];
+								for ( val=0; val<9; val++ )
+									if ( (state->cand[cell] & (1 << val)) && ((hidden ? ~items : bits) & (1 << val)) )
+									{
+										Eliminate( state, cell, val+1 );
+										removed = 1;
+									}
+							}
+						}
+						if ( removed )
+						{
+							count++;
+							if ( state->broken )
+								return count;
+							for ( ind=0; ind<num; ind++ )
+								mask[ind] = hidden ? state->where[unit][item[ind]] : state->cand[unitcells[unit][item[ind]]];
+						}
+					}
+				}
+		}
+
+	return count;
+}
+
+
+
+/*---Fish:	For each value, finds the fish of size lines (X-Wing for 2, swordfish for 3):  size rows in which the value can only go in size columns between them, so the value is in those columns only in those rows, and is removed from the rest of the columns.  The same with columns and rows swapped.  The cells of a row the value can go in are the columns (bit col of where), and the other way around, so the cover of the lines is the bitmasks of where together.  Returns the number of fish that removed candidates---*/
+static int Fish( GradeState *state, int size )
+{
+	/*---Define variables in function Fish---*/
+	unsigned char line[9];								//Lines (rows or columns, 0-8) in which the value is not placed
+	int val, base, num, i1, i2, i3, ind, cover, cell, removed, count = 0;		//Value (0-8), first unit of the base lines (0 for rows, 9 for columns), number of lines, the lines chosen (i1, i2 and i3, i3 equal to i2 for an X-Wing), generic use index (ind), a line of the cover, generic use cell, 1 once a candidate is removed, and number of fish that removed candidates
+	unsigned short lines, bits;							//The lines chosen as a bitmask, and their cells together (the cover)
+
+
+
+	for ( val=0; val<9 && !state->broken; val++ )
+		for ( base=0; base<18; base+=9 )
+		{
+			num = 0;
+			for ( ind=0; ind<9; ind++ )
+				if ( state->where[base+ind][val] != 0 )
+					line[num++] = (unsigned char)ind;
+			if ( num <= size )
+				continue;
+
+			for ( i1=0; i1<num; i1++ )
+				for ( i2=i1+1; i2<num && numbits[state->where[base+line[i1]][val]] <= size; i2++ )
+				{
+					if ( numbits[state->where[base+line[i1]][val] | state->where[base+line[i2]][val]] > size )
+						continue;
+					for ( i3=(size == 3 ? i2+1 : i2); i3<(size == 3 ? num : i2+1); i3++ )
+					{
+						bits = state->where[base+line[i1]][val] | state->where[base+line[i2]][val] | state->where[base+line[i3]][val];
+						if ( numbits[bits] != size )
+							continue;
+						lines = (unsigned short)( (1 << line[i1]) | (1 << line[i2]) | (1 << line[i3]) );
+
+						removed = 0;
+						for ( cover=0; cover<9; cover++ )
+							if ( bits & (1 << cover) )
+								for ( ind=0; ind<9; ind++ )
+								{
+									cell = unitcells[9-base+cover][ind];
+									if ( !(lines & (1 << ind)) && (state->cand[cell] & (1 << val)) )
+									{
+										Eliminate( state, cell, val+1 );
+										removed = 1;
+									}
+								}
+						if ( removed )
+						{
+							count++;
+							if ( state->broken )
+								return count;
+						}
+					}
+				}
+		}
+
+	return count;
+}
+
+
+
+/*---Chains:	Finds the shortest chain that removes candidates (see the highlights above) and applies it.  The strong links of every candidate are listed first.  Then from each candidate as the start, assumed false, a breadth-first search alternates strong links (to candidates then true) and weak links (to candidates then false), and notes each candidate made false that also sees the start (it is false whether the start is true or not), and the start if it is made true (it cannot be false).  The searches are cut at a number of strong links that grows by one in each pass over the starts (iterative deepening), so the first start with a deduction has the shortest chain, and the pass stops there.  A start whose search ends before reaching the cut has no chain, and is not searched again.  Short chains are the common case, and a search cut short costs far less than one over every candidate.  Every candidate removed by the chains of that start is removed, or the start is placed, and the length is left in chainlength.  Returns the number of candidates removed and values placed, 0 if no chain was found---*/
+static int Chains( GradeState *state )
+{
+	/*---Define variables in function Chains---*/
+	unsigned short strong[CHAINNODES][4];						//Candidates linked to each candidate by a strong link
+	unsigned char numstrong[CHAINNODES];						//Number of strong links of each candidate
+	unsigned char nochain[CHAINNODES];						//1 for each start with no chain, whose search ended before the cut
+	unsigned short queue[CHAINNODES*2];						//Queue of the search, each entry a candidate times 2, plus 1 if the candidate is true
+	unsigned char length[CHAINNODES*2];						//Strong links of the chain reaching each entry of the queue
+	unsigned long long candmask[9][2];						//Cells each value is a candidate of, as a set of cells (bit cell%64 of word cell/64)
+	unsigned long long reached[2][9][2];						//Candidates made false (reached[0]) and true (reached[1]) so far, as a set of cells for each value
+	unsigned long long seen[9][2];							//Candidates linked to the start by a weak link, as a set of cells for each value
+	unsigned long long fresh;							//Candidates of one value in one word of cells, made false by a true candidate and not reached before
+	unsigned short found[CHAINNODES];						//Candidates removed by the chains of the start
+	int numfound = 0, place = 0, maxlength, cut, startcut, last, count = 0;		//Number of candidates removed by the chains of the start, 1 if the start is made true, strong links the searches are cut at in this pass, 1 if a search was cut, 1 if the search from the start was cut (it reached a true candidate at the cut), 1 for a true candidate at the cut, and number of deductions applied
+	int start, node, other, cell, val, ind, word, unit, head, tail, len;		//Start of the chains, a candidate and another one, its cell and value (0-8), generic use index (ind) and word of a set of cells, generic use unit, head and tail of the queue, and strong links of the entry
+	unsigned short mask;								//Generic use bitmask
+
+
+
+	/*---List the strong links, the only other candidate of a cell, and the only other cell of a value in each unit---*/
+	memset( candmask, 0, sizeof(candmask) );
+	memset( nochain, 0, sizeof(nochain) );
+	for ( node=0; node<CHAINNODES; node++ )
+	{
+		cell = node/9;
+		val = node%9;
+		numstrong[node] = 0;
+		if ( !(state->cand[cell] & (1 << val)) )
+			continue;
+		candmask[val][cell/64] |= 1ULL << (cell%64);
+		if ( numbits[state->cand[cell]] == 2 )
+			strong[node][numstrong[node]++] = (unsigned short)( cell*9 + __builtin_ctz( state->cand[cell] & ~(1 << val) ) );
+		for ( ind=0; ind<3; ind++ )
+		{
+			unit = cellunits[cell][ind];
+			mask = state->where[unit][val];
+			if ( numbits[mask] == 2 )
+				strong[node][numstrong[node]++] = (unsigned short)( unitcells[unit][__builtin_ctz( mask & ~(1 << cellpos[cell][ind]) )]*9 + val );
+		}
+	}
+
+	for ( maxlength=1, cut=1; cut && maxlength<=CHAINMAXLENGTH; maxlength++ )
+	{
+		cut = 0;
+		for ( start=0; start<CHAINNODES; start++ )
+		{
+			if ( numstrong[start] == 0 || nochain[start] )
+				continue;
+			memset( reached, 0, sizeof(reached) );
+			memset( seen, 0, sizeof(seen) );
+			cell = start/9;
+			val = start%9;
+			reached[0][val][cell/64] = 1ULL << (cell%64);
+			for ( ind=0; ind<9; ind++ )
+				seen[ind][cell/64] = 1ULL << (cell%64);
+			seen[val][0] = peermask[cell][0];
+			seen[val][1] = peermask[cell][1];
+			queue[0] = (unsigned short)( start*2 );
+			length[0] = 0;
+			head = 0;
+			tail = 1;
+			startcut = 0;
+
+			while ( head < tail )
+			{
+				node = queue[head] >> 1;
+				len = length[head];
+				cell = node/9;
+				val = node%9;
+				if ( !(queue[head++] & 1) )
+				{
+					/*---A false candidate, each candidate linked to it by a strong link is true, with one more strong link---*/
+					for ( ind=0; ind<numstrong[node]; ind++ )
+					{
+						other = strong[node][ind];
+						if ( reached[1][other%9][other/9/64] & (1ULL << (other/9%64)) )
+							continue;
+						reached[1][other%9][other/9/64] |= 1ULL << (other/9%64);
+						queue[tail] = (unsigned short)( other*2 + 1 );
+						length[tail++] = (unsigned char)( len+1 );
+						place |= ( other == start );
+					}
+				}
+				else
+				{
+					/*---A true candidate, each candidate linked to it by a weak link is false:  its value in the peers of its cell, taken from the sets of cells a word at a time, and the other candidates of its cell.  At the cut only the ones that see the start matter (a false candidate there could only lead to longer chains), and they are not queued---*/
+					last = ( len == maxlength );
+					startcut |= last;
+					for ( word=0; word<2; word++ )
+					{
+						fresh = peermask[cell][word] & candmask[val][word] & ~reached[0][val][word] & (last ? seen[val][word] : ~0ULL);
+						reached[0][val][word] |= fresh;
+						for ( ; fresh != 0; fresh &= fresh-1 )
+						{
+							other = (word*64 + __builtin_ctzll( fresh ))*9 + val;
+							if ( seen[val][word] & fresh & -fresh )
+								found[numfound++] = (unsigned short)other;
+							if ( !last )
+							{
+								queue[tail] = (unsigned short)( other*2 );
+								length[tail++] = (unsigned char)len;
+							}
+						}
+					}
+					for ( mask=state->cand[cell] & ~(1 << val); mask!=0; mask&=mask-1 )
+					{
+						ind = __builtin_ctz( mask );
+						if ( (reached[0][ind][cell/64] & (1ULL << (cell%64))) || (last && !(seen[ind][cell/64] & (1ULL << (cell%64)))) )
+							continue;
+						reached[0][ind][cell/64] |= 1ULL << (cell%64);
+						other = cell*9 + ind;
+						if ( seen[ind][cell/64] & (1ULL << (cell%64)) )
+							found[numfound++] = (unsigned short)other;
+						if ( !last )
+						{
+							queue[tail] = (unsigned short)( other*2 );
+							length[tail++] = (unsigned char)len;
+						}
+					}
+				}
+			}
+			if ( place || numfound > 0 )
+				break;
+			nochain[start] = (unsigned char)!startcut;
+			cut |= startcut;
+		}
+		if ( start < CHAINNODES )
+			break;
+	}
+	if ( !place && numfound == 0 )
+		return 0;
+
+	/*---Place the start, or remove the candidates---*/
+	state->chainlength = maxlength;
+	if ( place )
+	{
+		Place( state, start/9, start%9 + 1 );
+		return 1;
+	}
+	for ( ind=0; ind<numfound; ind++ )
+		if ( state->cand[found[ind]/9] & (1 << found[ind]%9) )
+		{
+			Eliminate( state, found[ind]/9, found[ind]%9 + 1 );
+			count++;
+		}
+
+	return count;
+}
@@ -2,8 +2,27 @@
 #include <string.h>								//Manipulate strings and arrays of characters functions header file
 #include <time.h>								//Date and time functions header file
 #include <stdlib.h>								//General functions header file, like malloc
+#include <errno.h>								//Error codes header file, like EAGAIN
+#include <signal.h>								//Signal handling functions header file, for stopping server mode with SIGINT or SIGTERM
+#ifdef _WIN32
 #include <windows.h>								//Windows API functions header file (only works on Windows machines), like Sleep
+#endif
 #include <unistd.h>								//Unix functions header file, like sleep
+#include <pthread.h>								//POSIX threads functions header file, for solving puzzles in batch mode on several threads
+#ifndef _WIN32
+#include <fcntl.h>								//File control functions header file, like open
+#include <sys/mman.h>								//Memory mapping functions header file, like mmap, for reading the input file of batch mode in place
+#include <sys/stat.h>								//File status functions header file, like fstat
+#include <sys/socket.h>								//Socket functions header file, like accept, for server mode
+#include <sys/un.h>								//Unix domain socket addresses header file
+#include <netinet/in.h>								//Internet addresses header file, for server mode on a TCP port
+#include <arpa/inet.h>								//Internet address conversion functions header file, like htons
+#include <poll.h>								//Functions header file for waiting on several files at once (poll), for server mode
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>								//SSE2 intrinsics header file, for the puzzle parser (every x86-64 processor has SSE2)
+#endif
+#include "Sudoku.h"								//Sudoku solver library header file, the solving engines (file Sudoku.c)
 
 /*---C program to solve Sudoku puzzles
      by Jonathan Preston Cranford
@@ -13,19 +32,14 @@
 ---*/
 
 
-/*---Highlights of the solution method - also see 6) in the Summary below
-	1)  Uses recursion to solve the puzzle
-	2)  Allocates only bare minimum of memory need to run the program (see 2D array deadarr), and dynamically grows memory needed during execution of the program (for 2D array deadarr) using realloc command (memory reallocation)
----*/
+/*---The solving engines are in the Sudoku solver library (files Sudoku.h and Sudoku.c, see the highlights of the solution method there), this file is the program around them:  reading, printing and writing puzzles, batch mode, and the benchmark---*/
 
 
 /*---Summary of key program operations and functions used
-	1)  In function main(), program gets data from input file and stores in 2D array using functions GetFilePointer and CreateGridArr
-	2)  In function main(), program solves puzzle by calling function Solve
-	3)  In function Solve, empty cells of the puzzle grid are analyzed one by one by calling function AnalyzeCell
-	4)  In function AnalyzeCell, the value of the cell is changed to a value between 1 and 9 by calling function Change, and the new value is checked to see if it is in accordance with the rules of Sudoku (with respect to key values in rest of puzzle grid) via the function RuleCheckPass
-	5)  In function RuleCheckPass, it is also checked if the current solution has been tried before, which eliminates potential of infinite loops developing
-	6)  In function Change, if all possible values for current playable cell have been tried, then a dead end is reached, and the current solution is added to the list of dead end solutions in deadarr.  If more memory is needed for deadarr, it uses realloc to increase the memory available to deadarr by a little bit.  Finally, if a dead end is reached, Change recursively calls AnalyzeCell on the previous playable cell.
+	1)  In function main(), program gets data from input file and stores in a BigBoard (a 9x9, 16x16 or 25x25 puzzle) using functions GetFilePointer and CreateBoard
+	2)  In function main(), program solves puzzle by calling library function SudokuSolveBig (file Sudoku.c), then prints it and writes it to file with functions PrintPuzzle and WritePuzzle
+	3)  In batch mode (function SolveBatch or SolveBatchParallel), puzzles are read with ReadPuzzle, solved with library function SudokuSolve (or counted with SudokuCount, or solved through a cache of solved puzzles with SudokuCacheSolve), and written with OutputPuzzle
+	4)  In grade mode (function Grade), puzzles are read with ReadPuzzle, graded with library function SudokuGrade (file SudokuGrade.c), and their grades written with WriteGrade
 ---*/
    
    
@@ -33,43 +47,544 @@
    
    
 
+/*---Declaration of data types
+	Board:		The puzzle grid, 81 cells in one contiguous block in row-major order (cell = row*9 + col), each cell is 0 for an empty (playable) cell or a value 1-9.  Boards live on the stack or in arrays and are copied with memcpy (or plain assignment)
+	BigBoard:	A puzzle grid of any of the sizes solved (9x9, 16x16 or 25x25), used for reading, printing and writing puzzles of any size.  A 9x9 puzzle is copied to a Board to be solved
+	StatsSummary:	SudokuStats of all puzzles of a batch, summed and as histograms, and the file the SudokuStats of each puzzle are written to
+	Corpus:		A set of puzzles timed by the benchmark (-bench), read from a file or generated
+	PuzzleInput:	Input of batch mode, the whole input file mapped in memory (mmap), or a window of it read with fread (standard input, pipes, and Windows), parsed in place line by line (function NextLine)
+	PuzzleOutput:	Output of batch mode, solutions are formatted into a large buffer that is written to the file with one fwrite when it is full (function FlushOutput)
+	WorkQueue:	Range of puzzles [next, end) still to be solved by one worker thread, other worker threads can steal the back half of the range when they run out of work
+	BatchChunk:	A chunk of puzzles read from the input file, solved by all worker threads together
+	BatchThread:	State of one worker thread
+	BatchPool:	The worker threads of batch mode, kept running for the whole batch and handed one chunk at a time
+	GenerateChunk:	A chunk of puzzles being generated by the worker threads of generate mode (-generate)
+	ServerRequest:	One puzzle sent to server mode (-serve), and its reply
+	ServerConn:	One client connection of server mode, its input and output buffers and its requests not replied to yet
+	ServerState:	State of server mode shared by the main thread and the worker threads, the queue of requests waiting to be solved
+---*/
+typedef struct Board
+{
+	unsigned char cell[81];								//Value of each cell, row-major, 0 for an empty cell
+} Board;
+
+#define MAXDIM 25
+
+typedef struct BigBoard
+{
+	int dim;									//Number of rows, columns, regions and values, 9, 16 or 25
+	unsigned char cell[MAXDIM*MAXDIM];						//Value of each cell, row-major (cell = row*dim + col), 0 for an empty cell
+} BigBoard;
+
+
+#define INPUTBUFFER (1<<20)
+
+typedef struct PuzzleInput
+{
+	const char *data;								//The input mapped in memory, or the buffer holding the part of the input read so far
+	size_t size, pos;								//Number of bytes in data, and position of the next line in data
+	long lineno;									//Number of lines read so far, for error messages
+	int mapped;									//1 if data is the whole input file mapped in memory, 0 if it is a buffer filled with fread
+	FILE *fp;									//File read into the buffer, NULL once its end is reached (or if the file is mapped)
+	char *buffer;									//The buffer, INPUTBUFFER bytes (NULL if the file is mapped)
+} PuzzleInput;
+
+#define OUTPUTBUFFER (1<<22)
+
+typedef struct PuzzleOutput
+{
+	FILE *fp;									//Output file, standard output or a file opened by OpenOutput (unbuffered, the buffer below replaces the stdio one)
+	char *buffer;									//Buffer the solutions are formatted into, OUTPUTBUFFER bytes
+	size_t len;									//Number of bytes in the buffer not written yet
+	int compact;									//1 to write each puzzle as one line of characters (-compact), 0 for CSV format followed by a blank line
+	int error;									//1 if writing to the file failed
+} PuzzleOutput;
+
+#define STATSBUCKETS 64
+
+typedef struct StatsSummary
+{
+	FILE *fp;									//File the SudokuStats of each puzzle are written to, one JSON line per puzzle (-stats)
+	long numpuzzles;								//Number of puzzles recorded
+	SudokuStats total;								//Sum of the counters of all puzzles, maxdepth is the deepest of any puzzle
+	long nodes[STATSBUCKETS], micros[STATSBUCKETS];					//Histograms of the nodes visited and of the microseconds taken, bucket 0 counts the puzzles with 0, and bucket b the puzzles with 2^(b-1) to 2^b - 1
+} StatsSummary;
+
+typedef struct Corpus
+{
+	char name[64];									//Name of the corpus, the name of its file or the kind of puzzles generated
+	Board *puzzles;									//The puzzles, allocated by LoadCorpus or GenerateCorpus
+	long numpuzzles;								//Number of puzzles
+} Corpus;
+
+typedef struct WorkQueue
+{
+	pthread_mutex_t lock;								//Lock protecting next and end, taken by the owner and by thieves
+	long next, end;									//Index of next puzzle to be solved, and one past the last puzzle in the range
+} WorkQueue;
+
+#define PUZZLEABORTED -1
+
+typedef struct BatchChunk
+{
+	Board *puzzles;									//The puzzles of the chunk, solved in place
+	int *solved;									//For each puzzle, 1 if SudokuSolve found a solution, otherwise 0, or in count mode the number of solutions found by SudokuCount, PUZZLEABORTED if the search was aborted by its budget
+	SudokuStats *stats;								//For each puzzle, the counters of its search, NULL if not counted
+	long numpuzzles;								//Number of puzzles in the chunk
+} BatchChunk;
+
+typedef struct BatchPool
+{
+	pthread_mutex_t lock;								//Lock protecting chunk, round and busy
+	pthread_cond_t start;								//Signaled when a chunk is handed to the worker threads, and when they must exit
+	pthread_cond_t done;								//Signaled when the last worker thread finishes its share of the chunk
+	BatchChunk *chunk;								//Chunk being solved, NULL once the batch is done (the worker threads exit)
+	long round;									//Number of chunks handed out so far, so a worker thread tells a new chunk from the one it finished
+	int busy;									//Number of worker threads still working on the chunk
+} BatchPool;
+
+typedef struct BatchThread
+{
+	pthread_t thread;								//The worker thread
+	BatchPool *pool;								//The pool the worker thread belongs to
+	WorkQueue queue;								//Range of puzzles owned by the worker thread
+	struct BatchThread *all;							//All worker threads (for stealing work)
+	int id, numthreads;								//Index of this worker thread in all, and number of worker threads
+	int countlimit;									//0 to solve the puzzles, otherwise count their solutions up to countlimit (count mode)
+	const SudokuOptions *options;							//Engine and kernels the puzzles are solved with
+	SudokuCache *cache;								//Cache the puzzles are solved through, shared by all worker threads, NULL if not used
+	BatchChunk *chunk;								//The chunk of puzzles being solved, taken from the pool
+} BatchThread;
+
+#define GENANY 0
+#define GENEASY 1
+#define GENMEDIUM 2
+#define GENHARD 3
+#define GENHARDNODES 8
+#define GENMAXTRIES 100000
+
+typedef struct GenerateChunk
+{
+	Board *puzzles;									//The puzzles of the chunk
+	long *tries;									//For each puzzle, the number of candidates generated for it, 0 if none was kept
+	long first, numpuzzles;								//Place in the output of the first puzzle of the chunk, and number of puzzles in the chunk
+	WorkQueue queue;								//Puzzles of the chunk not taken yet, shared by all worker threads
+	int clues;									//Number of clues of each puzzle, 0 for as few as possible (a minimal puzzle)
+	int difficulty;									//Difficulty of each puzzle, GENEASY, GENMEDIUM or GENHARD, or GENANY
+	unsigned long long seed;							//Seed the puzzles are generated from
+} GenerateChunk;
+
+#define SERVERLINE 256
+#define SERVERREPLY 320
+#define SERVERBATCH 64
+#define SERVERMAXPENDING 4096
+#define SERVERMAXOUTPUT (SERVERMAXPENDING*SERVERREPLY)
+
+typedef struct ServerRequest
+{
+	Board board;									//The puzzle, solved in place
+	int stats;									//1 to reply with the counters of the search
+	int done;									//1 once the reply is written (set under the lock of ServerState)
+	char reply[SERVERREPLY];							//The reply, one line
+	int replylen;									//Length of the reply
+	struct ServerRequest *queuenext;						//Next request in the queue of the worker threads
+	struct ServerRequest *connnext;							//Next request of the same connection
+} ServerRequest;
+
+typedef struct ServerConn
+{
+	int fd;										//The socket of the connection
+	char in[SERVERLINE];								//Input read but not parsed yet, the start of a line
+	size_t inlen;									//Number of bytes in in
+	int skipping;									//1 while skipping a line longer than SERVERLINE
+	char *out;									//Replies not written yet, outsize bytes allocated
+	size_t outlen, outsize;								//Number of bytes in out, and bytes allocated
+	ServerRequest *first, *last;							//Requests not replied to yet, in the order they were read
+	long numpending;								//Number of requests not replied to yet
+	int eof;									//1 once the client has closed its side (or the connection failed), the connection is closed when all replies are written
+	int dead;									//1 if writing to the connection failed, its replies are dropped
+} ServerConn;
+
+typedef struct ServerState
+{
+	pthread_mutex_t lock;								//Lock protecting the queue, stop, the counters, and done of every request
+	pthread_cond_t ready;								//Signaled when requests are added to the queue, and on stop
+	ServerRequest *queuefirst, *queuelast;						//Requests waiting for a worker thread, in the order they were read
+	int stop;									//1 once the server is shutting down, the worker threads exit
+	int wakefd[2];									//Pipe the worker threads write a byte to when they finish a batch, to wake the main thread from poll
+	const SudokuOptions *options;							//Engine, kernels and budgets the puzzles are solved with
+	SudokuCache *cache;								//Cache the puzzles are solved through, NULL if not used
+	long numbatches, numsolved;							//Number of batches taken by the worker threads, and of requests in them
+} ServerState;
+
+
+
+/*---Names of the techniques of the grader (SUDOKUTECH codes), in the output of grade mode---*/
+static const char *technames[SUDOKUTECHNIQUES] = { "none", "hidden_single", "naked_single", "locked_candidates", "pair", "triple", "x_wing", "swordfish", "chain", "search" };
+
+
+
+/*---Global variables, set by the signal handler of server mode (function StopServer)---*/
+volatile sig_atomic_t serverstop = 0;							//1 once SIGINT or SIGTERM is received, the server shuts down
+int serverwakefd = -1;									//Write end of the wake-up pipe of the server, so the signal handler wakes the main thread from poll
+
+
+
 /*---Declaration of functions
 	GetFilePointer:	Get name of CSV file with unsolved puzzle, open the file for reading, and return pointer to the file
-	CreateGridArr:  Initializes 2D array of integers named "grid" representing the initial puzzle state collected from CSV file
+	CreateBoard:	Initializes the BigBoard representing the initial puzzle state collected from CSV file
 	PrintPuzzle:	Prints the current state of puzzle to standard output
-	Solve:		Solves the puzzle by visiting each individual playable cell and running the function AnalyzeCell on it
-	AnalyzeCell:	Analyzes the fitness and adjusts value of the current playable cell in the puzzle by running a loop of these two functions:  1) RuleCheckPass, and 2)  Change.  Returns pointer to deadarr.
-	RulecheckPass:	Checks the current state of the grid to see if all rules of Sudoku have been satisfied (1), otherwise returns 0
-	Change:		Changes value of current playable cell in grid, and if cycled through all possible numbers 1-9, it initiates recursion by calling function AnalyzeCell again on the previous playable cell.  Returns pointer to deadarr.
-	RelMem2DArr:	Releases memory reserved for a 2D array
-	RelMem1DArr:	Releases memory reserved for a 1D array
 	WritePuzzle:	Writes to file SolvedSudokuPuzzle.csv the solved state of the Sudoku puzzle
+	FWriteBigPuzzle:	Writes the state of the puzzle in comma-separated format to an already open file
+	OpenOutput:	Opens the output of batch mode, a file or standard output, and allocates its buffer.  Returns 1 if opened, 0 otherwise
+	CloseOutput:	Writes what is left in the buffer of the output of batch mode and closes it.  Returns 1 if everything was written, 0 if writing failed
+	FlushOutput:	Writes the buffer of the output of batch mode to the file, with one fwrite
+	OutputPuzzle:	Formats a 9x9 puzzle into the buffer of the output of batch mode, in CSV format followed by a blank line, or as one line of 81 characters
+	OutputBigPuzzle:	Same as OutputPuzzle, for a puzzle of any size
+	WriteCount:	Formats the number of solutions of a puzzle found by SudokuCount into the buffer of the output of batch mode, as one line
+	RecordStats:	Writes the SudokuStats of one puzzle of a batch as one JSON line, and adds them to the totals and histograms of the batch
+	PrintStatsSummary:	Writes the totals and histograms of the SudokuStats of a batch, as one JSON line to the stats file and as a table to standard error
+	SolveBatch:	Batch mode, reads puzzles one after another from the input with ReadPuzzle, solves them (or counts their solutions), and writes the solutions (or counts) to another open file, without any prompts.  Returns 0 if all puzzles were read and solved (or have exactly one solution), 1 otherwise
+	ReadPuzzle:	Reads the next puzzle from the input, in either 9-line CSV format or 81-character-per-line format.  Returns 1 if a puzzle was read, 0 at end of input, -1 if the puzzle format is wrong (the bad puzzle is skipped)
+	OpenInput:	Opens the input of batch mode, mapping a regular file in memory, or reading standard input or any other file through a buffer.  Returns 1 if opened, 0 if the file cannot be opened
+	CloseInput:	Unmaps or closes the input of batch mode
+	NextLine:	Gets the next line of the input, in place (not copied).  Returns the length of the line, or -1 at end of input
+	ParseLine81:	Converts a line of 81 characters (digits, with 0 or . for an empty cell) to the 81 cells of a Board, 16 characters at a time with SSE2.  Returns 1 if the line has the correct format, otherwise 0
+	SolveBatchParallel:	Same as SolveBatch, but puzzles are read in chunks, and each chunk is solved by a pool of worker threads (function BatchWorker) with work stealing, while the previous chunk is written and the next chunk is read.  Solutions are written in input order
+	ReadPuzzleChunk:	Reads up to maxpuzzles puzzles with ReadPuzzle into chunk, reporting and skipping puzzles with wrong format.  Returns the number of puzzles read
+	BatchWorker:	Worker thread of SolveBatchParallel, waits for each chunk handed to the pool and solves its share of it (function SolveChunk), until the batch is done
+	SolveChunk:	Solves puzzles from the own range of the chunk of a worker thread, then steals from the other worker threads until all puzzles of the chunk are taken
+	TakeWork:	Takes up to maxtake puzzles from the front of a worker queue.  Returns the index of the first puzzle taken, with end set to one past the last, or -1 if the queue is empty
+	SolveBatchBig:	Same as SolveBatch, for puzzles of one of the larger sizes, read with ReadBigPuzzle and solved with SudokuSolveBig
+	ReadBigPuzzle:	Same as ReadPuzzle, for a puzzle of any size, in CSV format or one line of characters.  Returns 1 if a puzzle was read, 0 at end of file, -1 if the puzzle format is wrong
+	ParseCSVRow:	Converts one row of a CSV puzzle file (e.g., 0,3,5,2,9,0,8,6,4), of a given length, to the cells of one row of a puzzle.  Returns 1 if the row has the correct format, otherwise 0
+	CloseCache:	Prints the hits and misses of the cache of batch or server mode, saves it to the cache file and frees it.  Returns 0, or 1 if the cache file cannot be written
+	ServePuzzles:	Server mode, solves puzzles sent by other programs over a Unix domain socket or a TCP port of localhost, one per line, in batches on a pool of worker threads (function ServerWorker), until SIGINT or SIGTERM.  Returns 0 after a clean shutdown, 1 if the socket cannot be opened
+	OpenServerSocket:	Opens the listening socket of server mode.  Returns the socket, or -1 if it cannot be opened
+	ReadRequests:	Reads what a client sent and turns each complete line into a request, queued for the worker threads
+	AppendOutput:	Adds a reply to the output of a connection.  Returns 1 if added, 0 if memory could not be allocated
+	ServerWorker:	Worker thread of server mode, solves batches of requests from the queue and writes their replies
+	StopServer:	Signal handler of server mode, makes the server shut down
+	Grade:		Grade mode, grades the difficulty of puzzles with the human techniques of library function SudokuGrade, and writes the grades as JSON lines.  Returns 0 if every puzzle was read and solved, 1 otherwise
+	WriteGrade:	Formats the grade of a puzzle into the buffer of the output of grade mode, as one JSON line
+	Benchmark:	Benchmark mode, times every corpus of puzzles with every engine and kernel, and writes the results as JSON lines.  Returns 0 if every puzzle was solved, 1 otherwise
+	LoadCorpus:	Reads all puzzles of a file into a corpus.  Returns 1 if at least one puzzle was read, 0 otherwise
+	GenerateCorpus:	Generates a corpus of puzzles of one kind (easy, minimal, 17-clue or adversarial), the same for the same seed
+	BenchCorpus:	Solves a corpus with the selected engine and kernels, warmup times untimed and then runs times timed, and writes the latency percentiles and puzzles per second.  Returns the number of puzzles not solved
+	Generate:	Generate mode, generates puzzles with exactly one solution on several threads (function GenerateWorker), with a given number of clues or difficulty, and writes them in the formats of batch mode.  Returns 0 if all puzzles were generated and written, 1 otherwise
+	GenerateWorker:	Worker thread of Generate, generates the puzzles of a chunk one at a time with GeneratePuzzle until none are left
+	GeneratePuzzle:	Generates one puzzle from a random solved grid, with values removed while it keeps exactly one solution, throwing away candidates with the wrong number of clues or difficulty.  Returns the number of candidates generated, 0 if none was kept
+	PuzzleDifficulty:	Rates a puzzle easy, medium or hard by the search the propagate engine needs for it.  Returns the rating
+	RandomGrid:	Fills a Board with a random solved grid
+	RemoveClues:	Removes the values of a solved grid in random order, keeping only those needed for the puzzle to have exactly one solution, down to minclues values
+	TransformPuzzle:	Changes a puzzle into a random equivalent one (same solving difficulty), by relabeling the values, reordering rows and columns within bands and stacks, reordering bands and stacks, and transposing
+	RandomPermutation:	Fills perm with a random order of 0 to n-1
+	NextRandom:	Returns the next number of a seeded pseudo-random sequence (splitmix64)
+	CompareDoubles:	Comparison function for qsort, orders doubles from lowest to highest
+	GetWallTime:	Returns the current wall clock time in seconds
 ---*/
 FILE *GetFilePointer( void );
-int **CreateGridArr( FILE *fp, int *numrows, int *numcols, int griddim, int *numplayable );
-void PrintPuzzle( int **grid, int numrows, int numcols );
-void Solve( int **grid, int numrows, int numcols, int numcells, int numplayable);
-int **AnalyzeCell( int **grid, int *rowplay, int *colplay, int indplay, int numcols, int numrows, int **deadarr, int *badrowsnum, int numcells, int *badrowsmem );
-int RuleCheckPass( int **grid, int *rowplay, int *colplay, int indplay, int numcols, int numrows, int **deadarr, int *badrowsnum );
-int **Change( int **grid, int *rowplay, int *colplay, int indplay, int numcols, int numrows, int start, int **deadarr, int *badrowsnum, int numcells, int *badrowsmem );
-void RelMem2DArr( int **myarr, int numrows );
-void RelMem1DArr( int *myarr );
-void WritePuzzle( int **grid, int numrows, int numcols);
+void CreateBoard( FILE *fp, BigBoard *board );
+void PrintPuzzle( const BigBoard *board );
+void WritePuzzle( const BigBoard *board );
+void FWriteBigPuzzle( FILE *fp, const BigBoard *board );
+int OpenOutput( const char *filename, int compact, PuzzleOutput *out );
+int CloseOutput( PuzzleOutput *out );
+void FlushOutput( PuzzleOutput *out );
+void OutputPuzzle( PuzzleOutput *out, const Board *board );
+void OutputBigPuzzle( PuzzleOutput *out, const BigBoard *board );
+void WriteCount( PuzzleOutput *out, int count, int limit );
+void RecordStats( StatsSummary *summary, int result, const SudokuStats *stats );
+void PrintStatsSummary( const StatsSummary *summary );
+int SolveBatch( PuzzleInput *in, PuzzleOutput *out, int splitthreads, int countlimit, const SudokuOptions *options, SudokuCache *cache, StatsSummary *summary );
+int SolveBatchParallel( PuzzleInput *in, PuzzleOutput *out, int numthreads, int countlimit, const SudokuOptions *options, SudokuCache *cache, StatsSummary *summary );
+long ReadPuzzleChunk( PuzzleInput *in, Board *chunk, long maxpuzzles, long *numbad );
+void *BatchWorker( void *arg );
+void SolveChunk( BatchThread *self );
+long TakeWork( WorkQueue *queue, long maxtake, long *end );
+int ReadPuzzle( PuzzleInput *in, Board *board );
+int OpenInput( const char *filename, PuzzleInput *in );
+void CloseInput( PuzzleInput *in );
+int NextLine( PuzzleInput *in, const char **line );
+int ParseLine81( const char *line, unsigned char *cell );
+int SolveBatchBig( PuzzleInput *in, PuzzleOutput *out, int dim, const SudokuOptions *options );
+int ReadBigPuzzle( PuzzleInput *in, BigBoard *board, int dim );
+int ParseCSVRow( const char *filerow, int len, int dim, unsigned char *row );
+int CloseCache( SudokuCache *cache, const char *cachename );
+int ServePuzzles( const char *socketname, int port, int numthreads, const SudokuOptions *options, SudokuCache *cache );
+int OpenServerSocket( const char *socketname, int port );
+void ReadRequests( ServerState *server, ServerConn *conn );
+int AppendOutput( ServerConn *conn, const char *reply, int len );
+void *ServerWorker( void *arg );
+void StopServer( int sig );
+int Grade( int argc, char *argv[] );
+void WriteGrade( PuzzleOutput *out, long puzzle, const Board *board, int status, const SudokuGrading *grade );
+int Benchmark( int argc, char *argv[] );
+int LoadCorpus( const char *filename, Corpus *corpus );
+void GenerateCorpus( int kind, long numpuzzles, unsigned long long seed, Corpus *corpus );
+long BenchCorpus( const Corpus *corpus, const SudokuOptions *options, const char *enginename, const char *kernelname, int runs, int warmup, unsigned long long seed, FILE *results );
+int Generate( int argc, char *argv[] );
+void *GenerateWorker( void *arg );
+long GeneratePuzzle( Board *board, long index, int clues, int difficulty, unsigned long long seed );
+int PuzzleDifficulty( const Board *board );
+void RandomGrid( Board *board, unsigned long long *rng );
+void RemoveClues( Board *board, int minclues, unsigned long long *rng );
+void TransformPuzzle( Board *board, unsigned long long *rng );
+void RandomPermutation( int *perm, int n, unsigned long long *rng );
+unsigned long long NextRandom( unsigned long long *rng );
+int CompareDoubles( const void *a, const void *b );
+double GetWallTime( void );
 
 
 
-/*---main():	Start of main function---*/
-int main()
+/*---main():	Start of main function.  With no command line arguments the puzzle file is asked for interactively, with -batch the puzzles are solved in batch mode:
+	SudokuSolver -batch [-o output file] [-compact] [-threads number of threads, 0 for one per processor] [-split] [-kernel scalar, sse42 or avx2] [-engine propagate or dlx] [-count limit] [-size 9, 16 or 25] [-stats file] [-maxnodes nodes] [-maxseconds seconds] [-maxmemory bytes] [-cache entries] [-cachefile file] [input file, or - for standard input]
+	SudokuSolver -bench [-o results file] [-runs number of timed runs] [-warmup number of untimed runs] [-puzzles number of puzzles generated of each kind] [-seed number] [puzzle files]
+	SudokuSolver -generate [-o output file] [-compact] [-puzzles number of puzzles] [-clues number of clues] [-difficulty easy, medium or hard] [-threads number of threads, 0 for one per processor] [-seed number]
+	SudokuSolver -serve [-socket file | -port number] [-threads number of threads, 0 for one per processor] [-kernel scalar, sse42 or avx2] [-engine propagate or dlx] [-maxnodes nodes] [-maxseconds seconds] [-maxmemory bytes] [-cache entries] [-cachefile file]
+	SudokuSolver -grade [-o output file] [-maxnodes nodes] [-maxseconds seconds] [-maxmemory bytes] [input file, or - for standard input]
+With -bench the engines and kernels are timed instead (function Benchmark), with -generate new puzzles are written instead (function Generate), and with -grade the difficulty of each puzzle is written instead (function Grade).  With -compact each solution is written as one line of characters (81 for a 9x9 puzzle) instead of in CSV format.  With -size 16 or -size 25 the puzzles are 16x16 or 25x25 (one thread, propagate engine, no counting).  With -count the solutions of each puzzle are counted up to limit (at least 2, 2 to check that each puzzle has exactly one solution), and one line is written for each puzzle with the number of solutions, followed by + if the limit was reached.  With -split the threads work together on the search of one puzzle at a time, instead of on different puzzles (propagate engine only).  With -engine dlx the puzzles are solved with the Dancing Links engine instead of constraint propagation.  With -stats the search of each puzzle is counted (nodes visited, backtracks, deepest level, propagations, eliminations and time) and written to the stats file as one JSON line per puzzle, followed by a summary line with the totals and histograms, also printed to standard error (9x9 puzzles, not with -split).  With -kernel the kernels are forced to the given instruction set, instead of the best one the processor supports.  With -maxnodes, -maxseconds and -maxmemory the search of each puzzle is aborted when it visits more nodes, takes longer, or goes deeper in its guessing than the copies of its state that fit in the memory given (for 9x9 puzzles a cap on the depth, the stack of 82 levels is reserved anyway), and the puzzle is written back unchanged and reported as aborted.  With -cache the puzzles are solved through a cache of up to entries solved puzzles (library function SudokuCacheSolve), so a puzzle equivalent to one solved before (the same up to relabeling the values, reordering rows, columns, bands and stacks, and transposing) is answered without searching.  With -cachefile the cache (of 100000 entries unless -cache is given) is loaded from the file at start, if it exists, and saved back to it at the end, so it is kept between runs.  The hits and misses of the cache are printed to standard error (solving 9x9 puzzles only, not with -count or -split).  With -serve the program keeps running as a server (function ServePuzzles), solving the puzzles other programs send over the Unix domain socket file given with -socket or the TCP port of localhost given with -port, with the options of batch mode that apply to one 9x9 puzzle at a time, until it gets SIGINT or SIGTERM
+---*/
+int main( int argc, char *argv[] )
 {
 	/*---Define variables in function main---*/
 	FILE *fp;							//Pointer to file with unsolved Sudoku puzzle
-	int griddim = 9;						//Number of cells in one dimension along grid array
-	int **grid = (int **)malloc( griddim*sizeof(int *) );		//The puzzle grid 2D array of integers
-	int numcells = 81;						//Number of cells in Sudoku puzzle grid
-	int numrows, numcols;						//Number of rows (numrows) and columns (numcols) in puzzle grid
-	int numplayable = 0;						//Number of empty cells (the 0's) in initial state of puzzle
-	int ind, row, col;						//Generic use index in loops (ind), row in 2D array (row), and column in 2D array (col)
+	BigBoard board;							//The puzzle grid
+	int ind;							//Generic use index in loops (ind)
 	char usrinp[100];						//Generic use string to get input from user from command line
+	PuzzleOutput out;						//Output in batch mode
+	const char *outname = NULL;					//Name of output file in batch mode, NULL for standard output
+	int compact = 0;						//In batch mode, 1 to write each solution as one line of characters (-compact)
+	PuzzleInput in;							//Input in batch mode
+	const char *inname = NULL;					//Name of input file in batch mode, NULL for standard input
+	int numthreads = 1;						//Number of worker threads in batch mode
+	int split = 0;							//In batch mode, 1 if the threads share the search of each puzzle (-split), 0 if they solve different puzzles
+	int countlimit = 0;						//In batch mode, 0 to solve the puzzles, otherwise count their solutions up to countlimit (-count)
+	int dim = 9;							//In batch mode, size of the puzzles (-size)
+	StatsSummary summary;						//In batch mode, SudokuStats of all puzzles
+	const char *statsname = NULL;					//Name of file the SudokuStats of each puzzle are written to in batch mode (-stats), NULL if not recorded
+	SudokuOptions options = { SUDOKUENGINEPROPAGATE, SUDOKUKERNELAUTO, 0, 0.0, 0, NULL };	//In batch mode, engine and kernels the puzzles are solved with (-engine and -kernel), and budgets of each search (-maxnodes, -maxseconds and -maxmemory)
+	static const char *kernelnames[] = { "auto", "scalar", "sse42", "avx2" };	//Names of the kernels for -kernel, in the order of the SUDOKUKERNEL codes
+	long cachesize = 0;						//In batch mode, most entries of the cache of solved puzzles (-cache), 0 for no cache
+	const char *cachename = NULL;					//Name of file the cache is loaded from and saved to in batch mode (-cachefile), NULL if not kept
+	SudokuCache *cache = NULL;					//In batch mode, the cache of solved puzzles, NULL if not used
+	int serve;							//1 in server mode (-serve), 0 in batch mode
+	const char *socketname = NULL;					//In server mode, name of the Unix domain socket file (-socket), NULL for a TCP port
+	int port = 0;							//In server mode, TCP port of localhost (-port), 0 for a Unix domain socket
+	
+	
+	
+	/*---Benchmark mode, times the engines and kernels on sets of puzzles---*/
+	if ( argc > 1 && strcmp( argv[1], "-bench" ) == 0 )
+		return Benchmark( argc-2, argv+2 );
+	
+	/*---Generate mode, writes new puzzles with exactly one solution---*/
+	if ( argc > 1 && strcmp( argv[1], "-generate" ) == 0 )
+		return Generate( argc-2, argv+2 );
+	
+	/*---Grade mode, grades the difficulty of puzzles by the techniques a person would need---*/
+	if ( argc > 1 && strcmp( argv[1], "-grade" ) == 0 )
+		return Grade( argc-2, argv+2 );
+	
+	/*---Batch mode, no prompts or banners, solutions are streamed to the output file (or server mode, which takes the same options)---*/
+	if ( argc > 1 )
+	{
+		if ( strcmp( argv[1], "-batch" ) != 0 && strcmp( argv[1], "-serve" ) != 0 )
+		{
+			fprintf( stderr, "Usage:  %s [-batch [-o output file] [-compact] [-threads number of threads, 0 for one per processor] [-split] [-kernel scalar, sse42 or avx2] [-engine propagate or dlx] [-count limit] [-size 9, 16 or 25] [-stats file] [-maxnodes nodes] [-maxseconds seconds] [-maxmemory bytes] [-cache entries] [-cachefile file] [input file, or - for standard input]]\n", argv[0] );
+			fprintf( stderr, "        %s -bench [-o results file] [-runs number of timed runs] [-warmup number of untimed runs] [-puzzles number of puzzles generated of each kind] [-seed number] [puzzle files]\n", argv[0] );
+			fprintf( stderr, "        %s -generate [-o output file] [-compact] [-puzzles number of puzzles] [-clues number of clues] [-difficulty easy, medium or hard] [-threads number of threads, 0 for one per processor] [-seed number]\n", argv[0] );
+			fprintf( stderr, "        %s -serve [-socket file | -port number] [-threads number of threads, 0 for one per processor] [-kernel scalar, sse42 or avx2] [-engine propagate or dlx] [-maxnodes nodes] [-maxseconds seconds] [-maxmemory bytes] [-cache entries] [-cachefile file]\n", argv[0] );
+			fprintf( stderr, "        %s -grade [-o output file] [-maxnodes nodes] [-maxseconds seconds] [-maxmemory bytes] [input file, or - for standard input]\n", argv[0] );
+			return 1;
+		}
+		serve = strcmp( argv[1], "-serve" ) == 0;
+		for ( ind=2; ind<argc; ind++ )
+		{
+			if ( strcmp( argv[ind], "-o" ) == 0 && ind+1 < argc )
+				outname = argv[++ind];
+			else if ( strcmp( argv[ind], "-stats" ) == 0 && ind+1 < argc )
+				statsname = argv[++ind];
+			else if ( strcmp( argv[ind], "-compact" ) == 0 )
+				compact = 1;
+			else if ( strcmp( argv[ind], "-threads" ) == 0 && ind+1 < argc )
+			{
+				numthreads = atoi( argv[++ind] );
+				if ( numthreads <= 0 )
+					numthreads = (int)sysconf( _SC_NPROCESSORS_ONLN );
+			}
+			else if ( strcmp( argv[ind], "-split" ) == 0 )
+				split = 1;
+			else if ( strcmp( argv[ind], "-kernel" ) == 0 && ind+1 < argc )
+			{
+				ind++;
+				for ( options.kernel=SUDOKUKERNELAVX2; options.kernel>SUDOKUKERNELAUTO; options.kernel-- )
+					if ( strcmp( argv[ind], kernelnames[options.kernel] ) == 0 )
+						break;
+				if ( (options.kernel == SUDOKUKERNELAUTO && strcmp( argv[ind], "auto" ) != 0) || SudokuCheckOptions( &options ) != SUDOKUOK )
+				{
+					fprintf( stderr, "ERROR - kernel %s is unknown or not supported by this processor\n", argv[ind] );
+					return 1;
+				}
+			}
+			else if ( strcmp( argv[ind], "-count" ) == 0 && ind+1 < argc )
+			{
+				countlimit = atoi( argv[++ind] );
+				if ( countlimit < 2 )
+				{
+					fprintf( stderr, "ERROR - the limit of -count must be at least 2\n" );
+					return 1;
+				}
+			}
+			else if ( strcmp( argv[ind], "-size" ) == 0 && ind+1 < argc )
+			{
+				dim = atoi( argv[++ind] );
+				if ( dim != 9 && dim != 16 && dim != 25 )
+				{
+					fprintf( stderr, "ERROR - the size must be 9, 16 or 25\n" );
+					return 1;
+				}
+			}
+			else if ( strcmp( argv[ind], "-engine" ) == 0 && ind+1 < argc )
+			{
+				ind++;
+				if ( strcmp( argv[ind], "propagate" ) == 0 )
+					options.engine = SUDOKUENGINEPROPAGATE;
+				else if ( strcmp( argv[ind], "dlx" ) == 0 )
+					options.engine = SUDOKUENGINEDLX;
+				else
+				{
+					fprintf( stderr, "ERROR - unknown engine %s\n", argv[ind] );
+					return 1;
+				}
+			}
+			else if ( strcmp( argv[ind], "-maxnodes" ) == 0 && ind+1 < argc )
+				options.maxnodes = atol( argv[++ind] );
+			else if ( strcmp( argv[ind], "-maxseconds" ) == 0 && ind+1 < argc )
+				options.maxseconds = atof( argv[++ind] );
+			else if ( strcmp( argv[ind], "-maxmemory" ) == 0 && ind+1 < argc )
+				options.maxmemory = atol( argv[++ind] );
+			else if ( strcmp( argv[ind], "-cache" ) == 0 && ind+1 < argc )
+			{
+				cachesize = atol( argv[++ind] );
+				if ( cachesize < 1 )
+				{
+					fprintf( stderr, "ERROR - the cache must hold at least 1 entry\n" );
+					return 1;
+				}
+			}
+			else if ( strcmp( argv[ind], "-cachefile" ) == 0 && ind+1 < argc )
+				cachename = argv[++ind];
+			else if ( strcmp( argv[ind], "-socket" ) == 0 && ind+1 < argc )
+				socketname = argv[++ind];
+			else if ( strcmp( argv[ind], "-port" ) == 0 && ind+1 < argc )
+			{
+				port = atoi( argv[++ind] );
+				if ( port < 1 || port > 65535 )
+				{
+					fprintf( stderr, "ERROR - the port must be 1 to 65535\n" );
+					return 1;
+				}
+			}
+			else if ( argv[ind][0] == '-' && argv[ind][1] != '\0' )
+			{
+				fprintf( stderr, "ERROR - unknown option %s of %s\n", argv[ind], argv[1] );
+				return 1;
+			}
+			else if ( strcmp( argv[ind], "-" ) != 0 )
+				inname = argv[ind];
+		}
+		if ( split &&(options.engine != SUDOKUENGINEPROPAGATE || countlimit > 0) )
+		{
+			fprintf( stderr, "ERROR - -split only works with the propagate engine, and not with -count\n" );
+			return 1;
+		}
+		if ( dim != 9 && (numthreads > 1 || options.engine != SUDOKUENGINEPROPAGATE || countlimit > 0) )
+		{
+			fprintf( stderr, "ERROR - 16x16 and 25x25 puzzles are solved on one thread with the propagate engine, and not with -count\n" );
+			return 1;
+		}
+		if ( statsname != NULL && (split || dim != 9) )
+		{
+			fprintf( stderr, "ERROR - -stats only works with 9x9 puzzles, and not with -split\n" );
+			return 1;
+		}
+		if ( serve != (socketname != NULL || port > 0) || (socketname != NULL && port > 0) )
+		{
+			fprintf( stderr, "ERROR - -serve needs either -socket or -port, and they only work with -serve\n" );
+			return 1;
+		}
+		if ( serve && (outname != NULL || compact || split || countlimit > 0 || dim != 9 || statsname != NULL || inname != NULL) )
+		{
+			fprintf( stderr, "ERROR - -serve solves one 9x9 puzzle at a time, and does not take -o, -compact, -split, -count, -size, -stats or an input file\n" );
+			return 1;
+		}
+		if ( (cachesize > 0 || cachename != NULL) && (split || dim != 9 || countlimit > 0) )
+		{
+			fprintf( stderr, "ERROR - -cache and -cachefile only work solving 9x9 puzzles, and not with -count or -split\n" );
+			return 1;
+		}
+		if ( cachesize > 0 || cachename != NULL )
+		{
+			if ( (cache = SudokuCacheCreate( cachesize > 0 ? cachesize : 100000 )) == NULL )
+			{
+				fprintf( stderr, "ERROR - unable to allocate the cache of solved puzzles, try fewer entries\n" );
+				return 1;
+			}
+			if ( cachename != NULL && SudokuCacheLoad( cache, cachename ) != SUDOKUOK )
+			{
+				fprintf( stderr, "ERROR - cache file %s cannot be read or is damaged\n", cachename );
+				return 1;
+			}
+		}
+		if ( serve )
+		{
+			ind = ServePuzzles( socketname, port, numthreads, &options, cache );
+			if ( CloseCache( cache, cachename ) != 0 )
+				ind = 1;
+			return ind;
+		}
+		if ( !OpenInput( inname, &in ) )
+		{
+			fprintf( stderr, "ERROR - unable to open input file %s\n", inname );
+			return 1;
+		}
+		if ( !OpenOutput( outname, compact, &out ) )
+		{
+			fprintf( stderr, "ERROR - unable to open output file %s\n", outname != NULL ? outname : "(standard output)" );
+			return 1;
+		}
+		memset( &summary, 0, sizeof(summary) );
+		if ( statsname != NULL && (summary.fp = fopen( statsname, "w" )) == NULL )
+		{
+			fprintf( stderr, "ERROR - unable to open stats file %s\n", statsname );
+			return 1;
+		}
+		if ( dim != 9 )
+			ind = SolveBatchBig( &in, &out, dim, &options );
+		else if ( numthreads > 1 && !split )
+			ind = SolveBatchParallel( &in, &out, numthreads, countlimit, &options, cache, summary.fp != NULL ? &summary : NULL );
+		else
+			ind = SolveBatch( &in, &out, split ? numthreads : 1, countlimit, &options, cache, summary.fp != NULL ? &summary : NULL );
+		CloseInput( &in );
+		if ( CloseCache( cache, cachename ) != 0 )
+			ind = 1;
+		if ( summary.fp != NULL )
+		{
+			PrintStatsSummary( &summary );
+			if ( fclose( summary.fp ) != 0 )
+			{
+				fprintf( stderr, "ERROR - unable to write all search statistics to stats file %s\n", statsname );
+				ind = 1;
+			}
+		}
+		if ( !CloseOutput( &out ) )
+		{
+			fprintf( stderr, "ERROR - unable to write all solutions to output file %s\n", outname != NULL ? outname : "(standard output)" );
+			ind = 1;
+		}
+		return ind;
+	}
 	
 	
 	
@@ -78,56 +593,34 @@ int main()
 	
 	
 	
-	/*---Checking for memory allocation errors---*/
-	if ( grid == NULL )
-	{
-		fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for puzzle grid, double check your input CSV file represents a 9x9 puzzle grid ... or try freeing up some memory by closing other programs and try again.  Now exiting\n\n\n");
-		exit(1);
-	}
-	
-	
-
-	/*---Allocate memory for columns in grid, and initialize to 0---*/
-	for ( ind=0; ind<griddim; ind++ )
-	{
-		grid[ind] = (int *)malloc( griddim*sizeof(int) );	//Checking for memory allocation errors
-		if ( grid[ind] == NULL )
-		{
-			fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for puzzle grid, double check your input CSV file represents a 9x9 puzzle grid ... or try freeing up some memory by closing other programs and try again.  Now exiting\n\n\n");
-			exit(1);
-		}
-	}
-	for ( row=0; row<griddim; row++ )	
-	{
-		for ( col=0; col<griddim; col++ )
-			grid[row][col] = 0;
-	}
-	
-	
-	
 	/*---Call functions to proceed with solving the puzzle---*/
 	fp = GetFilePointer();						//Get name of CSV file with unsolved puzzle, open the file for reading, and establish pointer fp to the file
 	
-	grid = CreateGridArr( fp, &numrows, &numcols, griddim, &numplayable );	//Initializes 2D array of integers named "grid" representing the initial puzzle state collected from CSV file
+	CreateBoard( fp, &board );					//Initializes the BigBoard representing the initial puzzle state collected from CSV file
 	
 	fclose( fp );							//Close the file fp
 	
 	printf("\n\n\nOriginal puzzle state is:\n\n");			//Print original state of puzzle to standard output
-	PrintPuzzle( grid, numrows, numcols );	
+	PrintPuzzle( &board );	
 	printf("\n\n\n");					
 	
-	Solve( grid, numrows, numcols, numcells, numplayable);		//Solves the puzzle by visiting each individual playable cell and running the function AnalyzeCell on it, the 2D array grid from function main() is updated automatically because it is passed into Solve as a pointer
+	printf( "\n\n\n|--------------------------------------------------SOLVING PUZZLE--------------------------------------------------|\n\n" );
+	
+	if ( SudokuSolveBig( board.dim, board.cell, board.cell, NULL ) != SUDOKUOK )	//Solves the puzzle with the Sudoku solver library, the solution is written over the cells of the BigBoard in function main()
+	{
+		printf( "\n\n\nSorry, this puzzle has no solution, double check your input CSV file of the original puzzle state.  Press enter to exit program  " );
+		fgets( usrinp, sizeof(usrinp), stdin );
+		return 0;
+	}
 	
 	//Print solved state of puzzle to standard output	
 	printf("\n\n\nSolved puzzle state is below, which is also found in output file \"SolvedSudokuPuzzle.csv\":\n\n");
-	PrintPuzzle( grid, numrows, numcols );
+	PrintPuzzle( &board );
 	
-	WritePuzzle( grid, numrows, numcols );				//Writes solved state of puzzle to file "SolvedSudokuPuzzle.csv"		
-	
-	RelMem2DArr( grid, griddim);					//Release memory used for 2D array grid
+	WritePuzzle( &board );						//Writes solved state of puzzle to file "SolvedSudokuPuzzle.csv"		
 	
 	printf( "\n\n\nOkay, all done, puzzle is solved, have a nice day!  Press enter to exit program  " );
-	gets( usrinp );
+	fgets( usrinp, sizeof(usrinp), stdin );
 	
 	
 	return 0;
@@ -157,11 +650,13 @@ FILE *GetFilePointer( void )
 	do										//Loop to ask for user to enter file until file name exists or user exits program
 	{
 		printf( "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n|--------------------------------------------------INSTRUCTIONS AND NOTES--------------------------------------------------|\n\n" );
-		printf( "A few instructions, notes, and comments about SudokuSolver before we get started:\n1)  SudokuSolver follows rules of Sudoku found at http://www.sudoku.name/rules/en\n2)  Input must be a comma separated file (CSV) of the initial Sudoku puzzle state\n3)  The CSV file format is 9 lines, with each line containing comma-separated numbers 0-9 (no spaces or blank lines in file)\n4)  A 0 in the CSV file represents a blank, playable cell in puzzle\n5)  Here is an example of the first few lines of a file with proper format (there is a blank line below, but this is not part of the file):\n\n0,3,5,2,9,0,8,6,4\n0,8,2,4,1,0,7,0,3\n...and so on up to line 9\n\n6)  The max file name size is 100 characters\n\n\n\n\n\n");
+		printf( "A few instructions, notes, and comments about SudokuSolver before we get started:\n1)  SudokuSolver follows rules of Sudoku found at http://www.sudoku.name/rules/en\n2)  Input must be a comma separated file (CSV) of the initial Sudoku puzzle state\n3)  The CSV file format is 9 lines, with each line containing comma-separated numbers 0-9 (no spaces or blank lines in file), or 16 or 25 lines of 16 or 25 numbers 0-16 or 0-25 for a 16x16 or 25x25 puzzle\n4)  A 0 in the CSV file represents a blank, playable cell in puzzle\n5)  Here is an example of the first few lines of a file with proper format (there is a blank line below, but this is not part of the file):\n\n0,3,5,2,9,0,8,6,4\n0,8,2,4,1,0,7,0,3\n...and so on up to line 9\n\n6)  The max file name size is 100 characters\n\n\n\n\n\n");
 		printf( "|--------------------------------------------------ENTER FILE WITH UNSOLVED SUDOKU PUZZLE--------------------------------------------------|\n\n" );
 		printf( "Okay, now please enter name of CSV file with unsolved Sudoku Puzzle and press enter\n\n" );
 		printf("File name (e.g., puzzles/input.csv), or type 0 and press enter to exit SudokuSolver:  ");
-		gets( filename );
+		if ( fgets( filename, sizeof(filename), stdin ) == NULL )		//Exit program if there is no more input
+			exit(0);
+		filename[strcspn( filename, "\r\n" )] = '\0';
 		
 		if ( strlen( filename ) == 1 && filename[0] == '0' )			//Exit program if user enters a 0
 		{
@@ -172,8 +667,11 @@ FILE *GetFilePointer( void )
 		if ( fp == NULL )							//User must enter another file name if file does not exist
 		{
 			printf( "\n\n\t\tOOPS!  That file does not exist, check you spelling and try again\n" );
+#ifdef _WIN32
 			Sleep( 5000 );
-//			sleep( 5 );
+#else
+			sleep( 5 );
+#endif
 			printf( "\n\n\n\n\n\n" );
 		}
 	}
@@ -184,384 +682,2252 @@ FILE *GetFilePointer( void )
 
 
 
-/*---CreateGridArr:	Initializes 2D array of integers named "grid" representing the initial puzzle state collected from CSV file---*/
-int **CreateGridArr( FILE *fp, int *numrows, int *numcols, int griddim, int *numplayable )
+/*---CreateBoard:	Initializes the BigBoard representing the initial puzzle state collected from CSV file.  The size of the puzzle (9x9, 16x16 or 25x25) is the number of values in the first row---*/
+void CreateBoard( FILE *fp, BigBoard *board )
 {
-	/*---Define variables in function CreateGridArr---*/
-	int **grid = (int **)malloc( griddim*sizeof(int *) );				//The puzzle grid 2D array of integers
-	char filerow[30];								//String for a row from the file (filerow) with unsolved puzzle
-	int ind, row, col;								//Generic use index in loops (ind), row in 2D array (row), and column in 2D array (col)
+	/*---Define variables in function CreateBoard---*/
+	char filerow[100];								//String for a row from the file (filerow) with unsolved puzzle
+	int row = 0;									//Row of the BigBoard being read (row)
+	const char *c;									//Generic use character of filerow
 	
 	
 	
-	/*---Checking for memory allocation errors---*/
-	if ( grid == NULL )
-	{
-		fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for puzzle grid, double check your input CSV file represents a 9x9 puzzle grid ... or try freeing up some memory by closing other programs and try again.  Now exiting\n\n\n");
-		exit(1);
-	}
-	
+	memset( board, 0, sizeof(*board) );
 	
-	
-	/*---Allocate memory for columns in grid, and initialize to 0---*/
-	for ( ind=0; ind<griddim; ind++ )
+	while ( fscanf(fp, "%99s", filerow) != EOF )					//Loop to read file until end of file
 	{
-		grid[ind] = (int *)malloc(griddim*sizeof(int));
-		if ( grid[ind] == NULL )						//Checking for memory allocation errors
+		if ( row == 0 )								//The size of the puzzle is the number of values in the first row
 		{
-			fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for puzzle grid, double check your input CSV file represents a 9x9 puzzle grid ... or try freeing up some memory by closing other programs and try again.  Now exiting\n\n\n");
-			exit(1);
+			board->dim = 1;
+			for ( c=filerow; *c; c++ )
+				board->dim += ( *c == ',' );
+			if ( board->dim != 9 && board->dim != 16 && board->dim != 25 )
+			{
+				printf("\n\nERROR - Puzzle must be 9x9, 16x16 or 25x25 grid of integers, check that the CSV file has these dimensions and try again.  Goodbye, enjoy\n\n\n");
+				exit(0);
+			}
 		}
-	}
-		
-	for ( row=0; row<griddim; row++ )	
-	{
-		for ( col=0; col<griddim; col++ )
-			grid[row][col] = 0;
-	}
-	
-	
-	
-	row = 0;
-	while ( fscanf(fp, "%s", filerow) != EOF )					//Loop to read file until end of file
-	{
-		if ( strlen(filerow) != 17 )						//If CSV file is not correct format, ask user to correct format for CSV file, and exit
+		if ( row == board->dim )						//If puzzle has more rows than values in a row, ask user to correct CSV file, and exit
 		{
-			printf( "\n\n\nERROR - something is wrong with the format of your CSV file, it should contain 9 rows of 9 numbers, with numbers in each row separated by commas, and no spaces, i.e.\n0,1,0,0,5,2,0,0,9\n0,0,0,0,1,0,0,2,8\n...and so on.  Check the format of your CSV file and retry.  Goodbye, enjoy\n\n\n" );
+			printf("\n\nERROR - Puzzle must be 9x9, 16x16 or 25x25 grid of integers, check that the CSV file has these dimensions and try again.  Goodbye, enjoy\n\n\n");
 			exit(0);
 		}
-		
-		col = 0;
-				
-		for ( ind=0; ind<strlen(filerow); ind++ )				//For loop to build a row of the 2D array grid
+		if ( !ParseCSVRow( filerow, (int)strlen( filerow ), board->dim, board->cell + row*board->dim ) )	//If CSV file is not correct format, ask user to correct format for CSV file, and exit
 		{
-			if ( ind==0 || (ind%2==0) )
-			{
-				grid[row][col] = (int)(filerow[ind]) - (int)('0');
-				if ( grid[row][col] == 0 )
-					(*numplayable)++;
-				col++;
-			}
+			printf( "\n\n\nERROR - something is wrong with the format of your CSV file, it should contain 9 rows of 9 numbers (or 16 of 16, or 25 of 25), with numbers in each row separated by commas, and no spaces, i.e.\n0,1,0,0,5,2,0,0,9\n0,0,0,0,1,0,0,2,8\n...and so on.  Check the format of your CSV file and retry.  Goodbye, enjoy\n\n\n" );
+			exit(0);
 		}
-		
 		row++;
 	}
 	
-	*numrows = row;
-	*numcols = col;
-	
-	if ( *numrows!=griddim || *numcols!=griddim )					//If puzzle does not have 9 rows and 9 columns, ask user to correct CSV file, and exit		
+	if ( row == 0 || row != board->dim )						//If puzzle does not have as many rows as values in a row, ask user to correct CSV file, and exit
 	{
-		printf("\n\nERROR - Puzzle must be 9x9 grid of integers, check that the CSV file has these dimensions and try again.  Goodbye, enjoy\n\n\n");
+		printf("\n\nERROR - Puzzle must be 9x9, 16x16 or 25x25 grid of integers, check that the CSV file has these dimensions and try again.  Goodbye, enjoy\n\n\n");
 		exit(0);
 	}
-	
-	return grid;
 }
 
 
+
 /*---PrintPuzzle:	Prints the current state of puzzle to standard output---*/
-void PrintPuzzle( int **grid, int numrows, int numcols )
+void PrintPuzzle( const BigBoard *board )
 {
-	/*---Define variables in function GetFilePointer---*/
-	int row, col;									//Generic use row in 2D array (row) and column in 2D array (col)
+	/*---Define variables in function PrintPuzzle---*/
+	int row, col;									//Generic use row (row) and column (col) of the BigBoard
 	
 	
 	
-	for ( row=0; row<numrows; row++ )						//Loop through rows and columns printing out cells to standard output
+	for ( row=0; row<board->dim; row++ )						//Loop through rows and columns printing out cells to standard output
 	{
-		for ( col=0; col<numcols; col++ )
-			printf( "%d\t", grid[row][col] );
+		for ( col=0; col<board->dim; col++ )
+			printf( "%d\t", board->cell[row*board->dim+col] );
 		printf( "\n" );
 	}
 }
 
 
 
-/*---Solve:	Solves the puzzle by visiting each individual playable cell and running the function AnalyzeCell on it---*/
-void Solve( int **grid, int numrows, int numcols, int numcells, int numplayable )
+/*---WritePuzzle:	Writes to file SolvedSudokuPuzzle.csv the solved state of the Sudoku puzzle---*/
+void WritePuzzle( const BigBoard *board )
 {
-	/*---Define variables in function GetFilePointer---*/
-	int badrowsmem = numcells;							//Number of rows in deadarr allocated in memory (can change dynamically during execution)
-	int badrowsnum = 0;								//Number of rows in deadarr, which is always <= badrowsmem
-	int **deadarr = (int **)malloc( badrowsmem*sizeof(int *) );			//2D array, where each row is a combination of numbers of playable cells in the Sudoku puzzle grid that leads to a dead end.  Memory is allocated so as too not use more memory than needed, but can be reallocated during execution if more space is needed
-	int *rowplay = (int *)malloc( numcells*sizeof(int) ); 				//1D arrays containing the row numbers of playable cells in puzzle grid (cells that are initially 0)
-	int *colplay = (int *)malloc( numcells*sizeof(int) );				//1D arrays containing the column numbers of playable cells in puzzle grid (cells that are initially 0)
-	int indplay = 0;								//The index in rowplay and colplay arrays of the current playable cell which is under consideration
-	int ind, row, col; 								//Generic use index in loops (ind), row in 2D array (row), and column in 2D array (col)
+	/*---Define variables in function WritePuzzle---*/
+	FILE *fp = fopen( "SolvedSudokuPuzzle.csv", "w" );				//Output file for solved Sudoku puzzle
 	
 	
-		
-	/*---Checking for memory allocation errors---*/
-	if ( deadarr == NULL || rowplay == NULL || colplay == NULL)
-	{
-		fprintf(stderr,"\n\n\nERROR - unable to allocate required memory, try freeing up some memory by closing other programs and try again.  It may also be that the puzzle is unsolvable, so try double checking your input CSV file of the original puzzle state.  Now exiting\n\n\n");
-		exit(1);
-	}
+	
+	FWriteBigPuzzle( fp, board );
+	
+	fclose(fp);
+}
+
+
+
+/*---FWriteBigPuzzle:	Writes the state of the puzzle in comma-separated format to an already open file, the values as numbers (1 to 25) separated by commas (no new line after the last row)---*/
+void FWriteBigPuzzle( FILE *fp, const BigBoard *board )
+{
+	/*---Define variables in function FWriteBigPuzzle---*/
+	int row, col;									//Generic use row (row) and column (col) of the BigBoard
 	
 	
 	
-	/*---Allocate memory for columns in 2D array deadarr and initialize to 0---*/
-	for ( ind=0; ind<badrowsmem; ind++ )
-	{
-		deadarr[ind] = (int *)malloc( numcells*sizeof(int) );
-		if ( deadarr[ind] == NULL )						//Checking for memory allocation errors
-		{
-			fprintf(stderr,"\n\n\nERROR - unable to allocate required memory, try freeing up some memory by closing other programs and try again.  It may also be that the puzzle is unsolvable, so try double checking your input CSV file of the original puzzle state.  Now exiting\n\n\n");
-			exit(1);
-		}
-	}
-	for ( row=0; row<badrowsmem; row++ )	
+	for ( row=0; row<board->dim; row++ )
 	{
-		for ( col=0; col<numcells; col++ )
-			deadarr[row][col] = 0;
+		for ( col=0; col<board->dim; col++ )
+			fprintf( fp, col != board->dim-1 ? "%d," : "%d", board->cell[row*board->dim+col] );
+		if ( row != board->dim-1 )
+			fputs( "\n", fp );
 	}
+}
 
 
 
-printf( "\n\n\n|--------------------------------------------------SOLVING PUZZLE--------------------------------------------------|\n\n" );
-	
-	/*---This is the beginning of the real meat of the program, where it actually solves the puzzle, and continues through functions AnalyzeCell, RuleCheckPass, Change---*/
-	for ( row=0; row<numrows; row++ )						//Loop through rows of 2D puzzle array
+/*---WriteCount:	Formats the number of solutions of a puzzle found by SudokuCount with a limit of limit into the buffer of the output, as one line, followed by + if the limit was reached (there may be more solutions), e.g. 0, 1 or 2+ for a limit of 2, or aborted if count is PUZZLEABORTED---*/
+void WriteCount( PuzzleOutput *out, int count, int limit )
+{
+	if ( out->len + 16 > OUTPUTBUFFER )
+		FlushOutput( out );
+	if ( count == PUZZLEABORTED )
+		out->len += (size_t)sprintf( out->buffer + out->len, "aborted\n" );
+	else
+		out->len += (size_t)sprintf( out->buffer + out->len, count >= limit ? "%d+\n" : "%d\n", count );
+}
+
+
+
+/*---OpenOutput:	Opens the output of batch mode, file filename for writing, or standard output if filename is NULL, and allocates its buffer.  The stdio buffering of the file is turned off, so each FlushOutput is one write to the file.  With compact, each puzzle is written as one line of characters instead of in CSV format.  Returns 1 if the output was opened, 0 if the file cannot be opened (or there is not enough memory)---*/
+int OpenOutput( const char *filename, int compact, PuzzleOutput *out )
+{
+	memset( out, 0, sizeof(*out) );
+	out->compact = compact;
+	out->fp = filename != NULL ? fopen( filename, "wb" ) : stdout;
+	out->buffer = (char *)malloc( OUTPUTBUFFER );
+	if ( out->fp == NULL || out->buffer == NULL )
 	{
-		for ( col=0; col<numcols; col++ )					//Loop through columns of 2D puzzle array
-		{
-			if (grid[row][col] == 0)					//If found empty cell, start looking for correct value of it
-			{
-				rowplay[indplay] = row;					//Add row of cell to list of row values of playable cells
-				colplay[indplay] = col;					//Add column of cell to list of column values of playable cells
-								
-				/*---Call function AnalyzeCell to look for correct value of cell, and sends new pointer to deadarr back to function Solve in case the memory for deadarr is reallocated during the call to AnalyzeCell---*/
-				deadarr = AnalyzeCell( grid, rowplay, colplay, indplay, numcols, numrows, deadarr, &badrowsnum, numcells, &badrowsmem );
-				
-				indplay++;						//Increase index counter of number of playable cells (represents next playable cell)
-				
-				if ( indplay/numplayable == 1 )
-					fprintf( stderr, "\rPercent solved:  %2.0f%% ... okay, all done, see below for the solution", ((float)indplay/(float)numplayable)*100  );
-				else
-					fprintf( stderr, "\rPercent solved:  %2.0f%% ... just hold on, I'll solve it soon!", ((float)indplay/(float)numplayable)*100  );
-			}
-		}
+		if ( out->fp != NULL && out->fp != stdout )
+			fclose( out->fp );
+		free( out->buffer );
+		return 0;
 	}
+	setvbuf( out->fp, NULL, _IONBF, 0 );
 	
-	
-	
-	/*---Release memory for arrays after done with them---*/
-	RelMem2DArr( deadarr, badrowsmem );
-	RelMem1DArr( rowplay );
-	RelMem1DArr( colplay );
+	return 1;
 }
 
 
 
-/*---AnalyzeCell:	Analyzes the fitness and adjusts value of the current playable cell in the puzzle by running a loop of these two functions:  1) RuleCheckPass, and 2)  Change.  Returns pointer to deadarr.---*/
-int** AnalyzeCell( int **grid, int *rowplay, int *colplay, int indplay, int numcols, int numrows, int **deadarr, int *badrowsnum, int numcells, int *badrowsmem )
+/*---CloseOutput:	Writes what is left in the buffer of the output of batch mode, closes the file (unless it is standard output) and frees the buffer.  Returns 1 if everything was written, 0 if writing to the file failed (e.g., the disk is full)---*/
+int CloseOutput( PuzzleOutput *out )
 {
-	/*---Define variables in function AnalyzeCell---*/
-	int start; 									//Starting value of current cell
+	FlushOutput( out );
+	if ( out->fp != stdout && fclose( out->fp ) != 0 )
+		out->error = 1;
+	free( out->buffer );
 	
+	return !out->error;
+}
 
 
-	if ( grid[rowplay[indplay]][colplay[indplay]] == 0 )				//Starting value of cell is 1 if cell was previously 0
-		start = 1;
-	else										//Starting value of cell is current value if AnalyzeCell called recursively
-		start = grid[rowplay[indplay]][colplay[indplay]];
-	
-	if ( grid[rowplay[indplay]][colplay[indplay]] == 9 )				//Change current value of cell so not testing same value twice, special case if current value is 9 (must wrap back to 1)
-		grid[rowplay[indplay]][colplay[indplay]] = 1;
-	else										//Change current value of cell so not testing same value twice
-		grid[rowplay[indplay]][colplay[indplay]]++;
-	
-	/*---Loop through possible values of current cell via function Change while the rules of Sudoku are not satisfied, checked via function RuleCheckPass---*/
-	while ( !( RuleCheckPass( grid, rowplay, colplay, indplay, numcols, numrows, deadarr, badrowsnum ) ) )
-	{		
-		/*---Function Change changes value of current playable cell in grid, and if cycled through all possible numbers 1-9, it initiates recursion by calling function AnalyzeCell again on the previous playable cell---*/
-		deadarr = Change( grid, rowplay, colplay, indplay, numcols, numrows, start, deadarr, badrowsnum, numcells, badrowsmem );
-	}
-		
-	return deadarr;									//Must return pointer to deadarr to original calling function, just in case memory is reallocated during a recursive call to AnalyzeCell
+
+/*---FlushOutput:	Writes the buffer of the output of batch mode to the file with one fwrite, and empties the buffer.  If writing fails, error is set and the rest of the output is thrown away---*/
+void FlushOutput( PuzzleOutput *out )
+{
+	if ( out->len > 0 && !out->error && fwrite( out->buffer, 1, out->len, out->fp ) != out->len )
+		out->error = 1;
+	out->len = 0;
 }
 
 
 
-/*---RuleCheckPass:	Checks the current state of the grid to see if all rules of Sudoku have been satisfied (returns 1), and if not, returns 0---*/
-int RuleCheckPass( int **grid, int *rowplay, int *colplay, int indplay, int numcols, int numrows, int **deadarr, int *badrowsnum )
+/*---OutputPuzzle:	Formats the state of a 9x9 puzzle into the buffer of the output of batch mode, flushing it first if it is full.  In CSV format (9 lines, followed by a blank line), each row is 8 digits interleaved with commas in one SSE2 unpack, then the 9th digit.  In compact format, the puzzle is one line of 81 digits (0 for an empty cell)---*/
+void OutputPuzzle( PuzzleOutput *out, const Board *board )
 {
-	/*---Define variables in function RuleCheckPass---*/
-	int ind, ind2, row, col;							//Generic use indices in loops (ind and ind2), row in 2D array (row), and column in 2D array (col)
-	int multrow, multcol;								//Used in determining what region of cells a given cell falls within
-	int val = grid[rowplay[indplay]][colplay[indplay]];				//Value of current cell
-	int regdim = 3;									//1D dimension of a  3x3 region of the grid
-	int numnonrepeat=0;								//In comparing current solution to rows of deadarr (array of solutions that lead to dead end), the number of rows that are not the same as current solution
-	
-	
+	/*---Define variables in function OutputPuzzle---*/
+	char *dst;									//Where the puzzle is formatted in the buffer
+	int row, ind;									//Row of the Board (row), and generic use index in loops (ind)
+#ifdef __SSE2__
+	const __m128i zero = _mm_set1_epi8( '0' ), comma = _mm_set1_epi8( ',' );	//Character 0 (zero) and , (comma) in every byte
+#endif
 	
-	/*---Check if no repetition column-wise, if not, return 0---*/
-	for ( col=0; col<numcols; col++ )
-	{
-		if ( (grid[rowplay[indplay]][col] == val) && (col != colplay[indplay]) )
-			return 0;
-	}
 	
 	
+	if ( out->len + 256 > OUTPUTBUFFER )
+		FlushOutput( out );
+	dst = out->buffer + out->len;
 	
-	/*---Check if no repetition row-wise, if not, return 0---*/
-	for ( row=0; row<numrows; row++ )
+	if ( out->compact )
 	{
-		if ( (grid[row][colplay[indplay]] == val) && (row != rowplay[indplay]) )
-			return 0;
+		for ( ind=0; ind<81; ind++ )
+			dst[ind] = (char)( '0' + board->cell[ind] );
+		dst[81] = '\n';
+		out->len += 82;
+		return;
 	}
 	
-	
-	
-	/*---Check if no repetition region-wise (3x3 grid is a region)---*/
-	multrow = rowplay[indplay]/regdim;						//Row region of current cell (0-2)
-	multcol = colplay[indplay]/regdim;						//Column region of current cell (0-2)
-	
-	for ( row=multrow*regdim; row<=multrow*regdim+(regdim-1); row++ )		//Loop to cycle through all cells in current region to make sure value of current cell is not repeated in the region
+	for ( row=0; row<9; row++, dst+=18 )
 	{
-		for ( col=multcol*regdim; col<=multcol*regdim+(regdim-1); col++ )
+#ifdef __SSE2__
+		_mm_storeu_si128( (__m128i *)dst, _mm_unpacklo_epi8( _mm_add_epi8( _mm_loadl_epi64( (const __m128i *)(board->cell + row*9) ), zero ), comma ) );
+#else
+		for ( ind=0; ind<8; ind++ )
 		{
-			if ( (grid[row][col] == val) && (row != rowplay[indplay]) && (col != colplay[indplay]) )
-				return 0;
+			dst[ind*2] = (char)( '0' + board->cell[row*9+ind] );
+			dst[ind*2+1] = ',';
 		}
+#endif
+		dst[16] = (char)( '0' + board->cell[row*9+8] );
+		dst[17] = '\n';
 	}
+	*dst = '\n';
+	out->len += 9*18 + 1;
+}
+
+
+
+/*---OutputBigPuzzle:	Same as OutputPuzzle, for a puzzle of any size:  in CSV format the values are numbers (1 to 25) separated by commas, and in compact format one character each (0 for an empty cell, 1-9, then A-P for 10-25)---*/
+void OutputBigPuzzle( PuzzleOutput *out, const BigBoard *board )
+{
+	/*---Define variables in function OutputBigPuzzle---*/
+	char *dst;									//Where the puzzle is formatted in the buffer
+	int cell, val;									//Cell of the BigBoard (cell), and its value (val)
 	
-	/*---Check to make sure not already tried this solution, and if did, means solution is a dead end and does not check out ---*/
-	for ( ind=0; ind<*badrowsnum; ind++ )						//Loop over rows of deadarr
+	
+	
+	if ( out->len + MAXDIM*MAXDIM*3 + MAXDIM + 2 > OUTPUTBUFFER )
+		FlushOutput( out );
+	dst = out->buffer + out->len;
+	
+	for ( cell=0; cell<board->dim*board->dim; cell++ )
 	{
-		for ( ind2=0; ind2<=indplay; ind2++ )					//Loop over playable cells that have been changed from 0
+		val = board->cell[cell];
+		if ( out->compact )
+			*dst++ = (char)( val < 10 ? '0' + val : 'A' + val - 10 );
+		else
 		{
-			if ( grid[rowplay[ind2]][colplay[ind2]] != deadarr[ind][ind2] )
-			{
-				numnonrepeat++;
-				break;
-			}
-				
+			if ( val >= 10 )
+				*dst++ = (char)( '0' + val/10 );
+			*dst++ = (char)( '0' + val%10 );
+			*dst++ = (cell+1) % board->dim ? ',' : '\n';
 		}
 	}
-	
-	if ( numnonrepeat == *badrowsnum )						//If current solution not found in array of dead end solutions, the value in this cell checks out (at least for now), else, solution does not work and Sudoku rules are effectively not satisfied
-		return 1;
-	else
-		return 0;
+	*dst++ = '\n';
+	out->len = (size_t)( dst - out->buffer );
 }
 
 
 
-/*---Change:	Changes value of current playable cell in grid, and if cycled through all possible numbers 1-9, it initiates recursion by calling function AnalyzeCell again on the previous playable cell.  Returns pointer to deadarr.---*/
-int ** Change( int **grid, int *rowplay, int *colplay, int indplay, int numcols, int numrows, int start, int **deadarr, int *badrowsnum, int numcells, int *badrowsmem ) 
+/*---RecordStats:	Writes the SudokuStats of the next puzzle of a batch to the stats file, as one JSON line, with result 1 if the puzzle was solved, 0 if not, or in count mode the number of solutions found by SudokuCount, PUZZLEABORTED (-1) if the search was aborted by its budget.  Then adds them to the totals of the batch and to the histograms of nodes visited and of microseconds taken---*/
+void RecordStats( StatsSummary *summary, int result, const SudokuStats *stats )
 {
-	/*---Define variables in function Change---*/
-	int val = grid[rowplay[indplay]][colplay[indplay]];				//Value of current cell
-	int ind, row, col;								//Generic use index in loops (ind), row in 2D array (row), and column in 2D array (col)
-	int **tmp;									//Temporary array used in reallocation of memory for deadarr, in order to make memory allocation bigger
+	/*---Define variables in function RecordStats---*/
+	long micros = (long)( stats->seconds*1e6 + 0.5 );				//Time taken by the puzzle, in microseconds
+	
+	
+	
+	summary->numpuzzles++;
+	fprintf( summary->fp, "{\"puzzle\":%ld,\"result\":%d,\"nodes\":%ld,\"backtracks\":%ld,\"max_depth\":%d,\"propagations\":%ld,\"eliminations\":%ld,\"micros\":%ld}\n",
+		summary->numpuzzles, result, stats->nodes, stats->backtracks, stats->maxdepth, stats->propagations, stats->eliminations, micros );
+	
+	summary->total.nodes += stats->nodes;
+	summary->total.backtracks += stats->backtracks;
+	summary->total.propagations += stats->propagations;
+	summary->total.eliminations += stats->eliminations;
+	summary->total.seconds += stats->seconds;
+	if ( stats->maxdepth > summary->total.maxdepth )
+		summary->total.maxdepth = stats->maxdepth;
+	
+	/*---Bucket b of a histogram holds the values with b significant bits, 2^(b-1) to 2^b - 1---*/
+	summary->nodes[stats->nodes > 0 ? 64 - __builtin_clzll( (unsigned long long)stats->nodes ) : 0]++;
+	summary->micros[micros > 0 ? 64 - __builtin_clzll( (unsigned long long)micros ) : 0]++;
+}
 
 
 
-	/*---Changes the value of the current cell---*/
-	if ( val == 9 )
-		val = 1;
-	else
-		val++;
+/*---PrintStatsSummary:	Writes the totals and the histograms of the SudokuStats of a batch, as one last JSON line to the stats file (each histogram as an array of puzzle counts by bucket, without its trailing empty buckets), and as a table to standard error---*/
+void PrintStatsSummary( const StatsSummary *summary )
+{
+	/*---Define variables in function PrintStatsSummary---*/
+	int ind, hist, last;								//Generic use index (ind), histogram being written (hist, 0 for nodes and 1 for microseconds), and its last bucket that is not empty (last)
+	const long *buckets;								//Buckets of the histogram being written
+	static const char *names[2] = { "nodes", "micros" };				//Name of each histogram
+	
 	
 	
+	fprintf( summary->fp, "{\"summary\":{\"puzzles\":%ld,\"nodes\":%ld,\"backtracks\":%ld,\"max_depth\":%d,\"propagations\":%ld,\"eliminations\":%ld,\"seconds\":%.6f",
+		summary->numpuzzles, summary->total.nodes, summary->total.backtracks, summary->total.maxdepth, summary->total.propagations, summary->total.eliminations, summary->total.seconds );
+	fprintf( stderr, "Search statistics of %ld puzzles:  %ld nodes, %ld backtracks, deepest level %d, %ld propagations, %ld eliminations, %.3f sec. solving\n",
+		summary->numpuzzles, summary->total.nodes, summary->total.backtracks, summary->total.maxdepth, summary->total.propagations, summary->total.eliminations, summary->total.seconds );
 	
-	/*---If cycled through all values for cell, then add this solution to the list of dead end solutions in deadarr (reallocate memory in deadarr if needed), and initiate recursive call of AnalyzeCell on the previous playable cell.  In other words, there is a problem further back, we must reach it to correct it---*/
-	if ( val == start )
+	for ( hist=0; hist<2; hist++ )
 	{
-		(*badrowsnum)++;
-
-		/*---Reallocate memory for deadarr if needed---*/
-		if ( *badrowsnum>*badrowsmem )
+		buckets = hist == 0 ? summary->nodes : summary->micros;
+		for ( last=STATSBUCKETS-1; last>0 && buckets[last] == 0; last-- )
+			;
+		
+		fprintf( summary->fp, ",\"%s_histogram\":[", names[hist] );
+		fprintf( stderr, "\t%23s\tpuzzles\n", names[hist] );
+		for ( ind=0; ind<=last; ind++ )
 		{
-			*badrowsmem = *badrowsmem + numcells;
-			tmp = (int **)realloc(deadarr, *badrowsmem*sizeof(int *));
-			if ( tmp == NULL )						//Checking for memory allocation errors
-			{
-				fprintf(stderr,"\n\n\nERROR - unable to allocate required memory, try freeing up some memory by closing other programs and try again.  It may also be that the puzzle is unsolvable, so try double checking your input CSV file of the original puzzle state.  Now exiting\n\n\n");
-				exit(1);
-			}
-			for ( ind=0; ind<(*badrowsmem); ind++ )
-			{
-				if ( ind >= (*badrowsnum-1) )
-				{
-					tmp[ind] = (int *)malloc(numcells*sizeof(int));
-					if ( tmp == NULL )				//Checking for memory allocation errors
-					{
-						fprintf(stderr,"\n\n\nERROR - unable to allocate required memory, try freeing up some memory by closing other programs and try again.  It may also be that the puzzle is unsolvable, so try double checking your input CSV file of the original puzzle state.  Now exiting\n\n\n");
-						exit(1);
-					}
-				}
-			}
-			deadarr = tmp;
+			fprintf( summary->fp, ind ? ",%ld" : "%ld", buckets[ind] );
+			if ( buckets[ind] == 0 )
+				continue;
+			fprintf( stderr, "\t%10llu - %10llu\t%ld\n", ind ? 1ULL << (ind-1) : 0ULL, ind ? (1ULL << (ind-1)) * 2 - 1 : 0ULL, buckets[ind] );
 		}
+		fprintf( summary->fp, "]" );
+	}
+	fprintf( summary->fp, "}}\n" );
+}
 
+
+
+/*---SolveBatch:	Batch mode, reads puzzles one after another from an open file with ReadPuzzle, solves them, and writes the solutions to another open file, without any prompts.  If splitthreads is more than 1, the search of each puzzle is split over that many threads with SudokuSolveSplit.  Each solution is written in CSV format followed by a blank line, and a puzzle with no solution is written back unchanged (with its 0's) so the output lines up with the input.  If countlimit is more than 0 (count mode), the solutions of each puzzle are counted up to countlimit with SudokuCount instead, and the count is written with WriteCount.  Puzzles are solved (or counted) with the engine and kernels of options, and if cache is not NULL through the cache with SudokuCacheSolve (not in count mode or with splitthreads).  If summary is not NULL, the search of each puzzle is counted and recorded with RecordStats (not with splitthreads).  A puzzle whose search is aborted by the budgets of options is written back unchanged (in count mode, as aborted).  Returns 0 if all puzzles were read and solved (in count mode, have exactly one solution), 1 otherwise---*/
+int SolveBatch( PuzzleInput *in, PuzzleOutput *out, int splitthreads, int countlimit, const SudokuOptions *options, SudokuCache *cache, StatsSummary *summary )
+{
+	/*---Define variables in function SolveBatch---*/
+	Board board;									//The puzzle grid, reused for every puzzle
+	long numsolved = 0, numunsolvable = 0, numbad = 0, nummultiple = 0, numaborted = 0;	//Number of puzzles solved (in count mode, with exactly one solution), with no solution, with wrong format, in count mode with more than one solution, and aborted by the budgets
+	int status, count;								//Return value of ReadPuzzle (status), and number of solutions found (count)
+	SudokuStats stats;								//Counters of the search of the puzzle, if recorded
+	SudokuStats *pstats = summary != NULL ? &stats : NULL;				//Where SudokuSolve and SudokuCount count the search, NULL if not recorded
+	double start = GetWallTime(), elapsed;						//Wall clock time at start of batch, and time taken by the batch
+	
+	
+	
+	while ( (status = ReadPuzzle( in, &board )) != 0 )
+	{
+		if ( status < 0 )
+		{
+			fprintf( stderr, "ERROR - wrong puzzle format ending at line %ld of input, puzzle skipped\n", in->lineno );
+			numbad++;
+			continue;
+		}
+		
+		if ( countlimit > 0 )
+		{
+			if ( SudokuCount( board.cell, countlimit, &count, board.cell, options, pstats ) == SUDOKUABORTED )
+				count = PUZZLEABORTED;
+			numaborted += ( count == PUZZLEABORTED );
+			numsolved += ( count == 1 );
+			numunsolvable += ( count == 0 );
+			nummultiple += ( count > 1 );
+			WriteCount( out, count, countlimit );
+		}
+		else
+		{
+			if ( splitthreads > 1 )
+				status = SudokuSolveSplit( board.cell, board.cell, splitthreads, options );
+			else
+				status = SudokuCacheSolve( cache, board.cell, board.cell, options, pstats );
+			if ( status == SUDOKUNOMEMORY )
+			{
+				fprintf( stderr, "ERROR - out of memory splitting the search of a puzzle\n" );
+				exit(1);
+			}
+			count = status == SUDOKUABORTED ? PUZZLEABORTED : ( status == SUDOKUOK );
+			numsolved += ( count == 1 );
+			numunsolvable += ( count == 0 );
+			numaborted += ( count == PUZZLEABORTED );
+			OutputPuzzle( out, &board );
+		}
+		
+		if ( summary != NULL )
+			RecordStats( summary, count, &stats );
+	}
+	
+	FlushOutput( out );
+	elapsed = GetWallTime() - start;
+	if ( countlimit > 0 )
+		fprintf( stderr, "Counted solutions of %ld puzzles (%ld with one solution, %ld with no solution, %ld with more than one, %ld aborted, %ld with wrong format) in %.3f sec., %.0f puzzles/sec.\n", numsolved+numunsolvable+nummultiple+numaborted, numsolved, numunsolvable, nummultiple, numaborted, numbad, elapsed, elapsed > 0 ? (numsolved+numunsolvable+nummultiple+numaborted)/elapsed : 0.0 );
+	else
+		fprintf( stderr, "Solved %ld puzzles (%ld with no solution, %ld aborted, %ld with wrong format) in %.3f sec., %.0f puzzles/sec.\n", numsolved, numunsolvable, numaborted, numbad, elapsed, elapsed > 0 ? (numsolved+numunsolvable+numaborted)/elapsed : 0.0 );
+	
+	return ( numunsolvable || nummultiple || numaborted || numbad ) ? 1 : 0;
+}
+
+
+
+/*---SolveBatchParallel:	Same as SolveBatch, but puzzles are read in chunks of BATCHCHUNK puzzles, and each chunk is solved by a pool of numthreads worker threads (function BatchWorker), started once and kept running for the whole batch.  While a chunk is being solved, the main thread writes the previous chunk and reads the next one, so reading and writing overlap with solving (three chunks take turns being read, solved and written).  Solutions (in count mode, counts) are written in input order, and so are the SudokuStats of each puzzle if summary is not NULL.  Returns 0 if all puzzles were read and solved (in count mode, have exactly one solution), 1 otherwise---*/
+#define BATCHCHUNK 16384
+int SolveBatchParallel( PuzzleInput *in, PuzzleOutput *out, int numthreads, int countlimit, const SudokuOptions *options, SudokuCache *cache, StatsSummary *summary )
+{
+	/*---Define variables in function SolveBatchParallel---*/
+	BatchChunk chunks[3];								//Chunks being read, solved and written, in turn
+	BatchChunk *prev = NULL;							//Chunk solved before the current one, still to be written, NULL if none
+	BatchPool pool;									//The worker threads, shared state
+	BatchThread *threads = (BatchThread *)malloc( numthreads*sizeof(BatchThread) );	//The worker threads
+	long numsolved = 0, numunsolvable = 0, numbad = 0, nummultiple = 0, numaborted = 0;	//Number of puzzles solved (in count mode, with exactly one solution), with no solution, with wrong format, in count mode with more than one solution, and aborted by the budgets
+	long ind, per;									//Generic use index in loops (ind), and number of puzzles given to each worker thread at the start of a chunk (per)
+	int cur = 0, th;								//Index in chunks of the chunk being solved (cur), and index of worker thread (th)
+	double start = GetWallTime(), elapsed;						//Wall clock time at start of batch, and time taken by the batch
+	
+	
+	
+	/*---Allocate memory for the chunks, and check for memory allocation errors---*/
+	for ( ind=0; ind<3; ind++ )
+	{
+		chunks[ind].puzzles = (Board *)malloc( BATCHCHUNK*sizeof(Board) );
+		chunks[ind].solved = (int *)malloc( BATCHCHUNK*sizeof(int) );
+		chunks[ind].stats = summary != NULL ? (SudokuStats *)malloc( BATCHCHUNK*sizeof(SudokuStats) ) : NULL;
+		chunks[ind].numpuzzles = 0;
+		if ( chunks[ind].puzzles == NULL || chunks[ind].solved == NULL || (summary != NULL && chunks[ind].stats == NULL) || threads == NULL )
+		{
+			fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for batch mode, try fewer threads, or try freeing up some memory by closing other programs and try again.  Now exiting\n\n\n");
+			exit(1);
+		}
+	}
+	
+	
+	
+	/*---Start the worker threads, waiting for the first chunk---*/
+	pthread_mutex_init( &pool.lock, NULL );
+	pthread_cond_init( &pool.start, NULL );
+	pthread_cond_init( &pool.done, NULL );
+	pool.chunk = &chunks[cur];
+	pool.round = 0;
+	pool.busy = 0;
+	for ( th=0; th<numthreads; th++ )
+	{
+		pthread_mutex_init( &threads[th].queue.lock, NULL );
+		threads[th].queue.next = threads[th].queue.end = 0;
+		threads[th].pool = &pool;
+		threads[th].all = threads;
+		threads[th].id = th;
+		threads[th].numthreads = numthreads;
+		threads[th].countlimit = countlimit;
+		threads[th].options = options;
+		threads[th].cache = cache;
+		threads[th].chunk = NULL;
+	}
+	for ( th=0; th<numthreads; th++ )
+	{
+		if ( pthread_create( &threads[th].thread, NULL, BatchWorker, &threads[th] ) != 0 )
+		{
+			fprintf(stderr,"\n\n\nERROR - unable to start worker thread, try fewer threads.  Now exiting\n\n\n");
+			exit(1);
+		}
+	}
+	
+	
+	
+	chunks[cur].numpuzzles = ReadPuzzleChunk( in, chunks[cur].puzzles, BATCHCHUNK, &numbad );
+	for ( ;; )
+	{
+		/*---Hand the current chunk to the worker threads, each one owning an equal range of puzzles to start with (no worker thread is busy, so the ranges are set without their locks)---*/
+		if ( chunks[cur].numpuzzles > 0 )
+		{
+			per = (chunks[cur].numpuzzles + numthreads - 1)/numthreads;
+			for ( th=0; th<numthreads; th++ )
+			{
+				threads[th].queue.next = th*per < chunks[cur].numpuzzles ? th*per : chunks[cur].numpuzzles;
+				threads[th].queue.end = (th+1)*per < chunks[cur].numpuzzles ? (th+1)*per : chunks[cur].numpuzzles;
+			}
+			pthread_mutex_lock( &pool.lock );
+			pool.chunk = &chunks[cur];
+			pool.round++;
+			pool.busy = numthreads;
+			pthread_cond_broadcast( &pool.start );
+			pthread_mutex_unlock( &pool.lock );
+		}
+		
+		/*---Write the solutions (in count mode, the counts) of the previous chunk in input order, while the worker threads solve the current one---*/
+		if ( prev != NULL )
+		{
+			for ( ind=0; ind<prev->numpuzzles; ind++ )
+			{
+				numsolved += ( prev->solved[ind] == 1 );
+				numunsolvable += ( prev->solved[ind] == 0 );
+				nummultiple += ( prev->solved[ind] > 1 );
+				numaborted += ( prev->solved[ind] == PUZZLEABORTED );
+				if ( countlimit > 0 )
+					WriteCount( out, prev->solved[ind], countlimit );
+				else
+					OutputPuzzle( out, &prev->puzzles[ind] );
+				if ( summary != NULL )
+					RecordStats( summary, prev->solved[ind], &prev->stats[ind] );
+			}
+		}
+		if ( chunks[cur].numpuzzles == 0 )
+			break;
+		
+		/*---Read the next chunk, then wait for the worker threads to finish the current one---*/
+		chunks[(cur+1)%3].numpuzzles = ReadPuzzleChunk( in, chunks[(cur+1)%3].puzzles, BATCHCHUNK, &numbad );
+		pthread_mutex_lock( &pool.lock );
+		while ( pool.busy > 0 )
+			pthread_cond_wait( &pool.done, &pool.lock );
+		pthread_mutex_unlock( &pool.lock );
+		
+		prev = &chunks[cur];
+		cur = (cur+1)%3;
+	}
+	
+	FlushOutput( out );
+	elapsed = GetWallTime() - start;
+	if ( countlimit > 0 )
+		fprintf( stderr, "Counted solutions of %ld puzzles (%ld with one solution, %ld with no solution, %ld with more than one, %ld aborted, %ld with wrong format) in %.3f sec. on %d threads, %.0f puzzles/sec.\n", numsolved+numunsolvable+nummultiple+numaborted, numsolved, numunsolvable, nummultiple, numaborted, numbad, elapsed, numthreads, elapsed > 0 ? (numsolved+numunsolvable+nummultiple+numaborted)/elapsed : 0.0 );
+	else
+		fprintf( stderr, "Solved %ld puzzles (%ld with no solution, %ld aborted, %ld with wrong format) in %.3f sec. on %d threads, %.0f puzzles/sec.\n", numsolved, numunsolvable, numaborted, numbad, elapsed, numthreads, elapsed > 0 ? (numsolved+numunsolvable+numaborted)/elapsed : 0.0 );
+	
+	
+	
+	/*---Stop the worker threads, and release memory---*/
+	pthread_mutex_lock( &pool.lock );
+	pool.chunk = NULL;
+	pthread_cond_broadcast( &pool.start );
+	pthread_mutex_unlock( &pool.lock );
+	for ( th=0; th<numthreads; th++ )
+	{
+		pthread_join( threads[th].thread, NULL );
+		pthread_mutex_destroy( &threads[th].queue.lock );
+	}
+	pthread_cond_destroy( &pool.start );
+	pthread_cond_destroy( &pool.done );
+	pthread_mutex_destroy( &pool.lock );
+	for ( ind=0; ind<3; ind++ )
+	{
+		free( chunks[ind].puzzles );
+		free( chunks[ind].solved );
+		free( chunks[ind].stats );
+	}
+	free( threads );
+	
+	return ( numunsolvable || nummultiple || numaborted || numbad ) ? 1 : 0;
+}
+
+
+
+/*---ReadPuzzleChunk:	Reads up to maxpuzzles puzzles with ReadPuzzle into chunk (parsed straight from the input into the Boards of the chunk), reporting and skipping puzzles with wrong format (counted in numbad).  Returns the number of puzzles read---*/
+long ReadPuzzleChunk( PuzzleInput *in, Board *chunk, long maxpuzzles, long *numbad )
+{
+	/*---Define variables in function ReadPuzzleChunk---*/
+	long numpuzzles = 0;								//Number of puzzles read into chunk
+	int status;									//Return value of ReadPuzzle
+	
+	
+	
+	while ( numpuzzles < maxpuzzles )
+	{
+		status = ReadPuzzle( in, &chunk[numpuzzles] );
+		if ( status == 0 )
+			break;
+		if ( status < 0 )
+		{
+			fprintf( stderr, "ERROR - wrong puzzle format ending at line %ld of input, puzzle skipped\n", in->lineno );
+			(*numbad)++;
+			continue;
+		}
+		numpuzzles++;
+	}
+	
+	return numpuzzles;
+}
+
+
+
+/*---BatchWorker:	Worker thread of SolveBatchParallel, waits for each chunk handed to the pool, solves its share of it with SolveChunk, and tells the main thread when the last worker thread is done with the chunk.  Exits once the pool has no chunk left (pool chunk set to NULL)---*/
+void *BatchWorker( void *arg )
+{
+	/*---Define variables in function BatchWorker---*/
+	BatchThread *self = (BatchThread *)arg;						//State of this worker thread
+	BatchPool *pool = self->pool;							//The pool of worker threads
+	long round = 0;									//Number of the last chunk solved by this worker thread
+	
+	
+	
+	for ( ;; )
+	{
+		pthread_mutex_lock( &pool->lock );
+		while ( pool->chunk != NULL && pool->round == round )
+			pthread_cond_wait( &pool->start, &pool->lock );
+		if ( pool->chunk == NULL )
+		{
+			pthread_mutex_unlock( &pool->lock );
+			return NULL;
+		}
+		round = pool->round;
+		self->chunk = pool->chunk;
+		pthread_mutex_unlock( &pool->lock );
+		
+		SolveChunk( self );
+		
+		pthread_mutex_lock( &pool->lock );
+		if ( --pool->busy == 0 )
+			pthread_cond_signal( &pool->done );
+		pthread_mutex_unlock( &pool->lock );
+	}
+}
+
+
+
+/*---SolveChunk:	Solves puzzles (in count mode, counts their solutions) in blocks from the front of the own range of the chunk of a worker thread.  When its own range is empty, it steals the back half of the range of another worker thread, and it returns once there is nothing left to steal---*/
+void SolveChunk( BatchThread *self )
+{
+	/*---Define variables in function SolveChunk---*/
+
+	BatchThread *victim;								//Worker thread work is stolen from
+	SudokuStats *stats;								//Counters of the search of the puzzle, NULL if not recorded
+	unsigned char *cell;								//Cells of the puzzle, solved in place
+	long first, end, ind, mid;							//Range of puzzles taken (first to end), generic use index (ind), and middle of a stolen range (mid)
+	int th, status;									//Index of worker thread (th), and status returned by SudokuCacheSolve or SudokuCount (status)
+	
+	
+	
+	for ( ;; )
+	{
+		/*---Solve a block of puzzles from the front of the own range---*/
+		while ( (first = TakeWork( &self->queue, 16, &end )) >= 0 )
+		{
+			for ( ind=first; ind<end; ind++ )
+			{
+				stats = self->chunk->stats != NULL ? &self->chunk->stats[ind] : NULL;
+				cell = self->chunk->puzzles[ind].cell;
+				if ( self->countlimit > 0 )
+					status = SudokuCount( cell, self->countlimit, &self->chunk->solved[ind], cell, self->options, stats );
+				else
+					self->chunk->solved[ind] = ( (status = SudokuCacheSolve( self->cache, cell, cell, self->options, stats )) == SUDOKUOK );
+				if ( status == SUDOKUABORTED )
+					self->chunk->solved[ind] = PUZZLEABORTED;
+			}
+		}
+		
+		
+		
+		/*---Own range is empty, steal the back half of the range of the first other worker thread that has work left---*/
+		for ( th=1; th<self->numthreads; th++ )
+		{
+			victim = &self->all[(self->id + th) % self->numthreads];
+			pthread_mutex_lock( &victim->queue.lock );
+			if ( victim->queue.end > victim->queue.next )
+			{
+				mid = victim->queue.next + (victim->queue.end - victim->queue.next)/2;
+				end = victim->queue.end;
+				victim->queue.end = mid;
+				pthread_mutex_unlock( &victim->queue.lock );
+				
+				pthread_mutex_lock( &self->queue.lock );		//Only one lock is held at a time, so worker threads stealing from each other cannot deadlock
+				self->queue.next = mid;
+				self->queue.end = end;
+				pthread_mutex_unlock( &self->queue.lock );
+				break;
+			}
+			pthread_mutex_unlock( &victim->queue.lock );
+		}
+		if ( th == self->numthreads )							//Nothing left to steal, all puzzles of the chunk are taken
+			return;
+	}
+}
+
+
+
+/*---TakeWork:	Takes up to maxtake puzzles from the front of a worker queue.  Returns the index of the first puzzle taken, with end set to one past the last puzzle taken, or -1 if the queue is empty---*/
+long TakeWork( WorkQueue *queue, long maxtake, long *end )
+{
+	/*---Define variables in function TakeWork---*/
+	long first = -1;								//Index of first puzzle taken
+	
+	
+	
+	pthread_mutex_lock( &queue->lock );
+	if ( queue->next < queue->end )
+	{
+		first = queue->next;
+		*end = queue->end - first > maxtake ? first + maxtake : queue->end;
+		queue->next = *end;
+	}
+	pthread_mutex_unlock( &queue->lock );
+	
+	return first;
+}
+
+
+
+/*---ReadPuzzle:	Reads the next puzzle from the input into board, in either 9-line CSV format (like CreateBoard) or 81-character-per-line format (digits, with 0 or . for an empty cell).  The lines are parsed in place, where NextLine finds them.  Blank lines and lines starting with # are skipped.  Returns 1 if a puzzle was read, 0 at end of input, -1 if the puzzle format is wrong (the bad puzzle is skipped, so the next call continues with the next puzzle)---*/
+int ReadPuzzle( PuzzleInput *in, Board *board )
+{
+	/*---Define variables in function ReadPuzzle---*/
+	const char *line;								//Line of the input, in place
+	int len, row;									//Length of line (len), and row of the Board (row)
+	
+	
+	
+	/*---Skip blank lines and comments up to the first line of the puzzle---*/
+	do
+	{
+		if ( (len = NextLine( in, &line )) < 0 )
+			return 0;
+	}
+	while ( len == 0 || line[0] == '#' );
+	
+	
+	
+	/*---81-character-per-line format---*/
+	if ( len == 81 )
+		return ParseLine81( line, board->cell ) ? 1 : -1;
+	
+	
+	
+	/*---9-line CSV format, the first row is already read---*/
+	for ( row=0; row<9; row++ )
+	{
+		if ( row > 0 && (len = NextLine( in, &line )) < 0 )
+			return -1;
+		if ( !ParseCSVRow( line, len, 9, board->cell + row*9 ) )
+			return -1;
+	}
+	
+	return 1;
+}
+
+
+
+/*---OpenInput:	Opens the input of batch mode, file filename, or standard input if filename is NULL.  A regular file is mapped in memory (mmap) and parsed in place, without copying.  Standard input, pipes, files that cannot be mapped, and every file on Windows are read instead with fread through a buffer of INPUTBUFFER bytes, a window of the input that NextLine moves along.  Returns 1 if the input was opened, 0 if the file cannot be opened---*/
+int OpenInput( const char *filename, PuzzleInput *in )
+{
+	/*---Define variables in function OpenInput---*/
+#ifndef _WIN32
+	struct stat info;								//Status of the file, for its type and size
+	void *map;									//The file mapped in memory
+	int fd;										//File descriptor of the file
+#endif
+	
+	
+	
+	memset( in, 0, sizeof(*in) );
+	
+#ifndef _WIN32
+	if ( filename != NULL )
+	{
+		fd = open( filename, O_RDONLY );
+		if ( fd < 0 )
+			return 0;
+		if ( fstat( fd, &info ) == 0 && S_ISREG( info.st_mode ) && info.st_size > 0 )
+		{
+			map = mmap( NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+			if ( map != MAP_FAILED )
+			{
+				madvise( map, (size_t)info.st_size, MADV_SEQUENTIAL );
+				close( fd );
+				in->data = (const char *)map;
+				in->size = (size_t)info.st_size;
+				in->mapped = 1;
+				return 1;
+			}
+		}
+		close( fd );
+	}
+#endif
+	
+	/*---Not mapped, read through the buffer---*/
+	in->fp = filename != NULL ? fopen( filename, "rb" ) : stdin;
+	in->buffer = (char *)malloc( INPUTBUFFER );
+	if ( in->fp == NULL || in->buffer == NULL )
+	{
+		if ( in->fp != NULL && in->fp != stdin )
+			fclose( in->fp );
+		free( in->buffer );
+		return 0;
+	}
+	in->data = in->buffer;
+	
+	return 1;
+}
+
+
+
+/*---CloseInput:	Unmaps the input file of batch mode, or closes it and frees its buffer---*/
+void CloseInput( PuzzleInput *in )
+{
+#ifndef _WIN32
+	if ( in->mapped )
+		munmap( (void *)in->data, in->size );
+#endif
+	if ( in->fp != NULL && in->fp != stdin )
+		fclose( in->fp );
+	free( in->buffer );
+}
+
+
+
+/*---NextLine:	Gets the next line of the input, without the new line (\n or \r\n), in place:  line is set to the start of the line in the mapped file or in the buffer, valid until the next call.  When the input is read through the buffer and the rest of the buffer holds no complete line, the rest is moved to the start of the buffer and the buffer is filled up with fread (a line longer than the whole buffer is cut, and fails the format checks).  Returns the length of the line, or -1 at end of input---*/
+int NextLine( PuzzleInput *in, const char **line )
+{
+	/*---Define variables in function NextLine---*/
+	const char *start, *end;							//Start of the line, and its new line (NULL if not found)
+	size_t len;									//Length of the line
+	
+	
+	
+	start = in->data + in->pos;
+	end = (const char *)memchr( start, '\n', in->size - in->pos );
+	if ( end == NULL && in->fp != NULL )						//Refill the buffer
+	{
+		len = in->size - in->pos;
+		memmove( in->buffer, start, len );
+		in->size = len + fread( in->buffer + len, 1, INPUTBUFFER - len, in->fp );
+		if ( in->size < INPUTBUFFER )						//End of the file
+		{
+			if ( in->fp != stdin )
+				fclose( in->fp );
+			in->fp = NULL;
+		}
+		in->pos = 0;
+		start = in->data;
+		end = (const char *)memchr( start + len, '\n', in->size - len );
+	}
+	
+	if ( end == NULL )								//Last line, with no new line
+	{
+		if ( in->pos == in->size )
+			return -1;
+		end = in->data + in->size;
+		in->pos = in->size;
+	}
+	else
+		in->pos = (size_t)( end - in->data ) + 1;
+	
+	in->lineno++;
+	len = (size_t)( end - start );
+	if ( len > 0 && start[len-1] == '\r' )
+		len--;
+	*line = start;
+	
+	return (int)len;
+}
+
+
+
+/*---ParseLine81:	Converts a line of 81 characters (digits 1-9, with 0 or . for an empty cell) to the 81 cells of a Board.  With SSE2, 16 characters are checked and converted at a time without branches (subtract '0', values above 9 are wrong unless the character is .), otherwise one character at a time, still without a branch per character.  Returns 1 if the line has the correct format, otherwise 0---*/
+int ParseLine81( const char *line, unsigned char *cell )
+{
+	/*---Define variables in function ParseLine81---*/
+	unsigned int bad = 0;								//Non-zero if a character is wrong
+	unsigned char val;								//Value of a character
+	int ind = 0;									//Generic use index in loops (ind)
+#ifdef __SSE2__
+	const __m128i zero = _mm_set1_epi8( '0' ), dot = _mm_set1_epi8( '.' ), nine = _mm_set1_epi8( 9 );	//Character 0 (zero) and . (dot), and 9 in every byte (nine)
+	__m128i chars, vals, dots;							//16 characters (chars), their values (vals), and the ones that are . (dots)
+	
+	
+	
+	for ( ; ind<80; ind+=16 )
+	{
+		chars = _mm_loadu_si128( (const __m128i *)(line + ind) );
+		vals = _mm_sub_epi8( chars, zero );
+		dots = _mm_cmpeq_epi8( chars, dot );
+		bad |= (unsigned int)_mm_movemask_epi8( _mm_andnot_si128( _mm_or_si128( _mm_cmpeq_epi8( _mm_min_epu8( vals, nine ), vals ), dots ), _mm_set1_epi8( -1 ) ) );
+		_mm_storeu_si128( (__m128i *)(cell + ind), _mm_andnot_si128( dots, vals ) );
+	}
+#endif
+	
+	for ( ; ind<81; ind++ )
+	{
+		val = (unsigned char)( line[ind] - '0' );
+		bad |= ( val > 9 ) & ( line[ind] != '.' );
+		cell[ind] = (unsigned char)( line[ind] == '.' ? 0 : val );
+	}
+	
+	return bad == 0;
+}
+
+
+
+/*---SolveBatchBig:	Same as SolveBatch, for puzzles of size dim x dim (16x16 or 25x25), read with ReadBigPuzzle, solved with SudokuSolveBig on one thread within the budgets of options, and written with OutputBigPuzzle.  Returns 0 if all puzzles were read and solved, 1 otherwise---*/
+int SolveBatchBig( PuzzleInput *in, PuzzleOutput *out, int dim, const SudokuOptions *options )
+{
+	/*---Define variables in function SolveBatchBig---*/
+	BigBoard board;									//The puzzle grid, reused for every puzzle
+	long numsolved = 0, numunsolvable = 0, numbad = 0, numaborted = 0;		//Number of puzzles solved, with no solution, with wrong format, and aborted by the budgets
+	int status;									//Return value of ReadBigPuzzle, then of SudokuSolveBig
+	double start = GetWallTime(), elapsed;						//Wall clock time at start of batch, and time taken by the batch
+	
+	
+	
+	while ( (status = ReadBigPuzzle( in, &board, dim )) != 0 )
+	{
+		if ( status < 0 )
+		{
+			fprintf( stderr, "ERROR - wrong puzzle format ending at line %ld of input, puzzle skipped\n", in->lineno );
+			numbad++;
+			continue;
+		}
+		
+		status = SudokuSolveBig( dim, board.cell, board.cell, options );
+		if ( status == SUDOKUNOMEMORY )
+		{
+			fprintf( stderr, "ERROR - out of memory for the search stack of a puzzle\n" );
+			exit(1);
+		}
+		numsolved += ( status == SUDOKUOK );
+		numaborted += ( status == SUDOKUABORTED );
+		numunsolvable += ( status != SUDOKUOK && status != SUDOKUABORTED );
+		
+		OutputBigPuzzle( out, &board );
+	}
+	
+	FlushOutput( out );
+	elapsed = GetWallTime() - start;
+	fprintf( stderr, "Solved %ld %dx%d puzzles (%ld with no solution, %ld aborted, %ld with wrong format) in %.3f sec., %.0f puzzles/sec.\n", numsolved, dim, dim, numunsolvable, numaborted, numbad, elapsed, elapsed > 0 ? (numsolved+numunsolvable+numaborted)/elapsed : 0.0 );
+	
+	return ( numunsolvable || numaborted || numbad ) ? 1 : 0;
+}
+
+
+
+/*---ReadBigPuzzle:	Same as ReadPuzzle, for a puzzle of size dim x dim, in either dim-line CSV format (like CreateBoard) or one line of dim*dim characters, with 0 or . for an empty cell, 1-9 for values 1-9 and letters A-P (or a-p) for values 10-25.  Blank lines and lines starting with # are skipped.  Returns 1 if a puzzle was read, 0 at end of input, -1 if the puzzle format is wrong---*/
+int ReadBigPuzzle( PuzzleInput *in, BigBoard *board, int dim )
+{
+	/*---Define variables in function ReadBigPuzzle---*/
+	const char *line;								//Line of the input, in place
+	int len, row, cell, val;							//Length of line (len), row of the BigBoard (row), cell of the BigBoard (cell), and value of a cell (val)
+	
+	
+	
+	board->dim = dim;
+	
+	/*---Skip blank lines and comments up to the first line of the puzzle---*/
+	do
+	{
+		if ( (len = NextLine( in, &line )) < 0 )
+			return 0;
+	}
+	while ( len == 0 || line[0] == '#' );
+	
+	
+	
+	/*---One line of characters---*/
+	if ( len == dim*dim )
+	{
+		for ( cell=0; cell<dim*dim; cell++ )
+		{
+			if ( line[cell] == '.' || line[cell] == '0' )
+				val = 0;
+			else if ( line[cell] >= '1' && line[cell] <= '9' )
+				val = line[cell] - '0';
+			else if ( line[cell] >= 'A' && line[cell] <= 'Z' )
+				val = line[cell] - 'A' + 10;
+			else if ( line[cell] >= 'a' && line[cell] <= 'z' )
+				val = line[cell] - 'a' + 10;
+			else
+				return -1;
+			if ( val > dim )
+				return -1;
+			board->cell[cell] = (unsigned char)val;
+		}
+		return 1;
+	}
+	
+	
+	
+	/*---dim-line CSV format, the first row is already read---*/
+	for ( row=0; row<dim; row++ )
+	{
+		if ( row > 0 && (len = NextLine( in, &line )) < 0 )
+			return -1;
+		if ( !ParseCSVRow( line, len, dim, board->cell + row*dim ) )
+			return -1;
+	}
+	
+	return 1;
+}
+
+
+
+/*---ParseCSVRow:	Converts one row of a CSV puzzle file (e.g., 0,3,5,2,9,0,8,6,4), len characters long (not necessarily ending with '\0'), to the dim cells in row, each value 0 to dim (two digits for the larger sizes).  A 9x9 row must be exactly 17 characters, and is checked without a branch per character.  Returns 1 if the row has the correct format, otherwise 0---*/
+int ParseCSVRow( const char *filerow, int len, int dim, unsigned char *row )
+{
+	/*---Define variables in function ParseCSVRow---*/
+	const char *end = filerow + len;						//End of the row
+	unsigned int bad = 0;								//Non-zero if a character is wrong (9x9 row)
+	int ind, val;									//Generic use index in loops (ind), and value of a cell (val)
+	
+	
+	
+	if ( dim == 9 )
+	{
+		if ( len != 17 )
+			return 0;
+		for ( ind=0; ind<9; ind++ )
+		{
+			row[ind] = (unsigned char)( filerow[ind*2] - '0' );
+			bad |= ( row[ind] > 9 );
+		}
+		for ( ind=1; ind<17; ind+=2 )
+			bad |= ( filerow[ind] != ',' );
+		return bad == 0;
+	}
+	
+	for ( ind=0; ind<dim; ind++ )
+	{
+		if ( filerow == end || *filerow < '0' || *filerow > '9' )
+			return 0;
+		for ( val=0; filerow < end && *filerow >= '0' && *filerow <= '9' && val <= dim; filerow++ )
+			val = val*10 + (*filerow - '0');
+		if ( val > dim )
+			return 0;
+		row[ind] = (unsigned char)val;
+		
+		if ( ind != dim-1 && (filerow == end || *filerow++ != ',') )
+			return 0;
+	}
+	
+	return filerow == end;
+}
+
+
+
+/*---CloseCache:	Prints the hits, misses and entries of the cache of batch or server mode to standard error, saves it to cache file cachename (unless NULL), and frees it.  Does nothing if cache is NULL.  Returns 0, or 1 if the cache file cannot be written---*/
+int CloseCache( SudokuCache *cache, const char *cachename )
+{
+	/*---Define variables in function CloseCache---*/
+	long hits, misses, entries;							//Puzzles answered from the cache, puzzles solved because they were not in it, and entries in it
+	int status = 0;									//Value returned
+	
+	
+	
+	if ( cache == NULL )
+		return 0;
+	SudokuCacheCounts( cache, &entries, &hits, &misses );
+	fprintf( stderr, "Cache:  %ld hits, %ld misses, %ld entries\n", hits, misses, entries );
+	if ( cachename != NULL && SudokuCacheSave( cache, cachename ) != SUDOKUOK )
+	{
+		fprintf( stderr, "ERROR - unable to write the cache to cache file %s\n", cachename );
+		status = 1;
+	}
+	SudokuCacheFree( cache );
+	
+	return status;
+}
+
+
+
+#ifndef _WIN32
+/*---ServePuzzles:	Server mode (-serve), solves the puzzles other programs send over the Unix domain socket socketname, or if it is NULL over TCP port port of localhost (127.0.0.1), until SIGINT or SIGTERM (function StopServer).  The main thread accepts the connections and reads and writes all of them with poll, never waiting on one client, and parses each line read into a request (function ReadRequests).  The requests of all connections go into one queue, and numthreads worker threads (function ServerWorker) take them in batches of up to SERVERBATCH, so requests that arrive together are solved together, with the engine, kernels and budgets of options and through cache (unless NULL).  The replies are written back on each connection in the order of its requests.  Returns 0 after a clean shutdown, 1 if the socket cannot be opened---*/
+int ServePuzzles( const char *socketname, int port, int numthreads, const SudokuOptions *options, SudokuCache *cache )
+{
+	/*---Define variables in function ServePuzzles---*/
+	ServerState server;								//State shared with the worker threads
+	ServerConn **conns = NULL, *conn;						//The open connections, and generic use connection
+	ServerRequest *request;								//Generic use request
+	struct pollfd *fds = NULL;							//What poll watches, the listening socket, the wake-up pipe, then the connections
+	pthread_t *threads = (pthread_t *)malloc( numthreads*sizeof(pthread_t) );	//The worker threads
+	int listenfd, numconns = 0, maxconns = 0, numpolled, ind, th, fd;		//Listening socket, number of open connections and of connections there is room for, connections polled, generic use index (ind), index of worker thread (th), and new connection (fd)
+	long numserved = 0, numconnections = 0;						//Number of requests replied to, and of connections accepted
+	char drain[256];								//Bytes read from the wake-up pipe, not used
+	ssize_t len;									//Bytes written to a connection
+	double start = GetWallTime(), elapsed;						//Wall clock time at start, and time served
+	
+	
+	
+	if ( (listenfd = OpenServerSocket( socketname, port )) < 0 )
+		return 1;
+	
+	memset( &server, 0, sizeof(server) );
+	server.options = options;
+	server.cache = cache;
+	pthread_mutex_init( &server.lock, NULL );
+	pthread_cond_init( &server.ready, NULL );
+	if ( threads == NULL || pipe( server.wakefd ) != 0 )
+	{
+		fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for server mode, try fewer threads.  Now exiting\n\n\n");
+		exit(1);
+	}
+	fcntl( server.wakefd[0], F_SETFL, O_NONBLOCK );
+	fcntl( server.wakefd[1], F_SETFL, O_NONBLOCK );
+	serverwakefd = server.wakefd[1];
+	for ( th=0; th<numthreads; th++ )
+	{
+		if ( pthread_create( &threads[th], NULL, ServerWorker, &server ) != 0 )
+		{
+			fprintf(stderr,"\n\n\nERROR - unable to start worker thread, try fewer threads.  Now exiting\n\n\n");
+			exit(1);
+		}
+	}
+	signal( SIGINT, StopServer );
+	signal( SIGTERM, StopServer );
+	signal( SIGPIPE, SIG_IGN );							//A client that goes away makes write fail instead of ending the program
+	if ( socketname != NULL )
+		fprintf( stderr, "Serving puzzles on socket %s with %d threads\n", socketname, numthreads );
+	else
+		fprintf( stderr, "Serving puzzles on 127.0.0.1 port %d with %d threads\n", port, numthreads );
+	
+	
+	
+	while ( !serverstop )
+	{
+		/*---Wait for a new connection, finished requests (a byte in the wake-up pipe), requests to read (unless a connection has SERVERMAXPENDING requests in flight, or more than SERVERMAXOUTPUT bytes of replies its client has not read, so a client that never reads cannot grow the server without bound), or replies that can be written---*/
+		if ( fds == NULL || numconns == maxconns )
+		{
+			maxconns = numconns > 2*maxconns ? numconns : 2*maxconns + 16;
+			fds = (struct pollfd *)realloc( fds, (maxconns+2)*sizeof(struct pollfd) );
+			conns = (ServerConn **)realloc( conns, maxconns*sizeof(ServerConn *) );
+			if ( fds == NULL || conns == NULL )
+			{
+				fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for server mode, too many connections.  Now exiting\n\n\n");
+				exit(1);
+			}
+		}
+		fds[0].fd = listenfd;
+		fds[0].events = POLLIN;
+		fds[1].fd = server.wakefd[0];
+		fds[1].events = POLLIN;
+		for ( ind=0; ind<numconns; ind++ )
+		{
+			fds[ind+2].fd = conns[ind]->fd;
+			fds[ind+2].events = (short)( ( conns[ind]->eof || conns[ind]->numpending >= SERVERMAXPENDING || conns[ind]->outlen > SERVERMAXOUTPUT ? 0 : POLLIN ) | ( conns[ind]->outlen > 0 && !conns[ind]->dead ? POLLOUT : 0 ) );
+			if ( fds[ind+2].events == 0 )
+				fds[ind+2].fd = -1;						//Nothing to wait for, and poll would keep reporting a hang up
+		}
+		numpolled = numconns;
+		if ( poll( fds, (nfds_t)(numpolled+2), -1 ) < 0 )
+			continue;								//Interrupted by a signal, serverstop is checked
+		
+		if ( fds[1].revents & POLLIN )
+			while ( read( server.wakefd[0], drain, sizeof(drain) ) > 0 )
+				;
+		
+		/*---Read the requests of every connection that has data, and accept a new connection---*/
+		for ( ind=0; ind<numpolled; ind++ )
+			if ( fds[ind+2].revents & (POLLIN | POLLHUP | POLLERR) )
+				ReadRequests( &server, conns[ind] );
+		if ( (fds[0].revents & POLLIN) && (fd = accept( listenfd, NULL, NULL )) >= 0 )
+		{
+			fcntl( fd, F_SETFL, O_NONBLOCK );
+			conn = (ServerConn *)calloc( 1, sizeof(ServerConn) );
+			if ( conn == NULL || numconns == maxconns )
+			{
+				close( fd );							//Out of memory, or no room until the next time around
+				free( conn );
+			}
+			else
+			{
+				conn->fd = fd;
+				conns[numconns++] = conn;
+				numconnections++;
+			}
+		}
+		
+		/*---Move the replies finished by the worker threads to the output of their connection, in order, write what can be written, and close finished connections---*/
+		for ( ind=0; ind<numconns; ind++ )
+		{
+			conn = conns[ind];
+			pthread_mutex_lock( &server.lock );
+			while ( (request = conn->first) != NULL && request->done )
+			{
+				if ( !conn->dead && !AppendOutput( conn, request->reply, request->replylen ) )
+					conn->dead = 1;
+				conn->first = request->connnext;
+				conn->numpending--;
+				numserved++;
+				free( request );
+			}
+			pthread_mutex_unlock( &server.lock );
+			if ( conn->first == NULL )
+				conn->last = NULL;
+			
+			if ( conn->outlen > 0 && !conn->dead )
+			{
+				len = write( conn->fd, conn->out, conn->outlen );
+				if ( len > 0 )
+				{
+					memmove( conn->out, conn->out + len, conn->outlen - (size_t)len );
+					conn->outlen -= (size_t)len;
+				}
+				else if ( len < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR )
+					conn->dead = 1;					//The client went away, its replies are dropped
+			}
+			if ( conn->dead )
+				conn->eof = 1;
+			if ( conn->eof && conn->numpending == 0 && (conn->outlen == 0 || conn->dead) )
+			{
+				close( conn->fd );
+				free( conn->out );
+				free( conn );
+				conns[ind--] = conns[--numconns];
+			}
+		}
+	}
+	
+	
+	
+	/*---Shut down:  stop the worker threads (requests not solved yet are dropped), close every connection, and remove the socket file---*/
+	pthread_mutex_lock( &server.lock );
+	server.stop = 1;
+	pthread_cond_broadcast( &server.ready );
+	pthread_mutex_unlock( &server.lock );
+	for ( th=0; th<numthreads; th++ )
+		pthread_join( threads[th], NULL );
+	for ( ind=0; ind<numconns; ind++ )
+	{
+		while ( (request = conns[ind]->first) != NULL )
+		{
+			conns[ind]->first = request->connnext;
+			free( request );
+		}
+		close( conns[ind]->fd );
+		free( conns[ind]->out );
+		free( conns[ind] );
+	}
+	close( listenfd );
+	serverwakefd = -1;
+	close( server.wakefd[0] );
+	close( server.wakefd[1] );
+	if ( socketname != NULL )
+		unlink( socketname );
+	
+	elapsed = GetWallTime() - start;
+	fprintf( stderr, "Served %ld puzzles on %ld connections in %.3f sec., %.1f puzzles per batch\n", numserved, numconnections, elapsed, server.numbatches > 0 ? (double)server.numsolved/server.numbatches : 0.0 );
+	
+	
+	
+	/*---Release memory---*/
+	pthread_mutex_destroy( &server.lock );
+	pthread_cond_destroy( &server.ready );
+	free( fds );
+	free( conns );
+	free( threads );
+	
+	return 0;
+}
+
+
+
+/*---OpenServerSocket:	Opens the listening socket of server mode, the Unix domain socket socketname (a socket file left by a server that is not running any more is removed first), or if socketname is NULL TCP port port of localhost, so only programs on this machine can connect.  The socket does not block.  Returns the socket, or -1 if it cannot be opened (the reason is written to standard error)---*/
+int OpenServerSocket( const char *socketname, int port )
+{
+	/*---Define variables in function OpenServerSocket---*/
+	struct sockaddr_un unixaddr;							//Address of the Unix domain socket
+	struct sockaddr_in tcpaddr;							//Address of the TCP port
+	struct stat info;								//Status of an existing socket file
+	int fd, yes = 1;								//The socket, and the value of SO_REUSEADDR
+	
+	
+	
+	if ( socketname != NULL )
+	{
+		memset( &unixaddr, 0, sizeof(unixaddr) );
+		unixaddr.sun_family = AF_UNIX;
+		if ( strlen( socketname ) >= sizeof(unixaddr.sun_path) )
+		{
+			fprintf( stderr, "ERROR - socket name %s is too long\n", socketname );
+			return -1;
+		}
+		strcpy( unixaddr.sun_path, socketname );
+		if ( (fd = socket( AF_UNIX, SOCK_STREAM, 0 )) < 0 )
+		{
+			fprintf( stderr, "ERROR - unable to create socket %s: %s\n", socketname, strerror( errno ) );
+			return -1;
+		}
+		if ( stat( socketname, &info ) == 0 && S_ISSOCK( info.st_mode ) )
+		{
+			if ( connect( fd, (struct sockaddr *)&unixaddr, sizeof(unixaddr) ) == 0 )
+			{
+				fprintf( stderr, "ERROR - another server is already running on socket %s\n", socketname );
+				close( fd );
+				return -1;
+			}
+			unlink( socketname );						//Left by a server that stopped without removing it
+		}
+		if ( bind( fd, (struct sockaddr *)&unixaddr, sizeof(unixaddr) ) != 0 || listen( fd, SOMAXCONN ) != 0 )
+		{
+			fprintf( stderr, "ERROR - unable to listen on socket %s: %s\n", socketname, strerror( errno ) );
+			close( fd );
+			return -1;
+		}
+	}
+	else
+	{
+		memset( &tcpaddr, 0, sizeof(tcpaddr) );
+		tcpaddr.sin_family = AF_INET;
+		tcpaddr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+		tcpaddr.sin_port = htons( (unsigned short)port );
+		if ( (fd = socket( AF_INET, SOCK_STREAM, 0 )) < 0 )
+		{
+			fprintf( stderr, "ERROR - unable to create socket for port %d: %s\n", port, strerror( errno ) );
+			return -1;
+		}
+		setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes) );
+		if ( bind( fd, (struct sockaddr *)&tcpaddr, sizeof(tcpaddr) ) != 0 || listen( fd, SOMAXCONN ) != 0 )
+		{
+			fprintf( stderr, "ERROR - unable to listen on port %d: %s\n", port, strerror( errno ) );
+			close( fd );
+			return -1;
+		}
+	}
+	fcntl( fd, F_SETFL, O_NONBLOCK );
+	
+	return fd;
+}
+
+
+
+/*---ReadRequests:	Reads what the client sent on connection conn and turns each complete line into a request, added to the requests of the connection in order.  A blank line is skipped.  A puzzle of 81 characters (digits, with 0 or . for an empty cell, parsed with ParseLine81), optionally followed by a space and stats, goes into the queue of the worker threads (all requests of one read at once, with one lock); any other line (or a line longer than SERVERLINE) gets the reply error right away.  At end of input or on an error, eof of the connection is set, and at end of input a last line with no newline is still turned into a request---*/
+void ReadRequests( ServerState *server, ServerConn *conn )
+{
+	/*---Define variables in function ReadRequests---*/
+	ServerRequest *request, *first = NULL, *last = NULL;				//Request of a line, and first and last of the requests for the queue
+	ssize_t len = read( conn->fd, conn->in + conn->inlen, SERVERLINE - conn->inlen );	//Number of bytes read
+	size_t start = 0, pos, linelen;							//Start of the next line in the buffer of the connection, generic use position (pos), and length of a line
+	int ok;										//1 if the line has the correct format
+	
+	
+	
+	if ( len == 0 && (conn->inlen > 0 || conn->skipping) )				//End of input in the middle of a line, end the line so it gets its reply too (the buffer always has room left for the newline)
+	{
+		conn->in[conn->inlen] = '\n';
+		len = 1;
+		conn->eof = 1;
+	}
+	else if ( len <= 0 )
+	{
+		if ( len == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) )
+			conn->eof = 1;
+		return;
+	}
+	conn->inlen += (size_t)len;
+	
+	for ( pos=0; pos<conn->inlen; pos++ )
+	{
+		if ( conn->in[pos] != '\n' )
+			continue;
+		linelen = pos - start;
+		if ( linelen > 0 && conn->in[pos-1] == '\r' )
+			linelen--;
+		if ( linelen == 0 && !conn->skipping )					//Blank line
+		{
+			start = pos+1;
+			continue;
+		}
+		
+		request = (ServerRequest *)calloc( 1, sizeof(ServerRequest) );
+		if ( request == NULL )
+		{
+			fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for server mode.  Now exiting\n\n\n");
+			exit(1);
+		}
+		ok = !conn->skipping && linelen >= 81 && ParseLine81( conn->in + start, request->board.cell );
+		if ( ok && linelen > 81 )
+		{
+			ok = linelen == 87 && memcmp( conn->in + start + 81, " stats", 6 ) == 0;
+			request->stats = 1;
+		}
+		if ( ok )
+		{
+			if ( last != NULL )
+				last->queuenext = request;
+			else
+				first = request;
+			last = request;
+		}
+		else
+		{
+			request->replylen = (int)sprintf( request->reply, "error\n" );
+			request->done = 1;
+		}
+		if ( conn->last != NULL )
+			conn->last->connnext = request;
+		else
+			conn->first = request;
+		conn->last = request;
+		conn->numpending++;
+		conn->skipping = 0;
+		start = pos+1;
+	}
+	
+	/*---Keep the start of an incomplete line for the next read, or skip a line longer than the buffer (it gets the reply error once it ends)---*/
+	conn->inlen -= start;
+	memmove( conn->in, conn->in + start, conn->inlen );
+	if ( conn->inlen == SERVERLINE )
+	{
+		conn->skipping = 1;
+		conn->inlen = 0;
+	}
+	
+	if ( first != NULL )
+	{
+		pthread_mutex_lock( &server->lock );
+		if ( server->queuelast != NULL )
+			server->queuelast->queuenext = first;
+		else
+			server->queuefirst = first;
+		server->queuelast = last;
+		pthread_cond_broadcast( &server->ready );
+		pthread_mutex_unlock( &server->lock );
+	}
+}
+
+
+
+/*---AppendOutput:	Adds len bytes of reply to the output of connection conn, growing it as needed.  Returns 1 if added, 0 if memory could not be allocated---*/
+int AppendOutput( ServerConn *conn, const char *reply, int len )
+{
+	/*---Define variables in function AppendOutput---*/
+	char *grown;									//The output, moved to a larger block
+	
+	
+	
+	if ( conn->outlen + (size_t)len > conn->outsize )
+	{
+		grown = (char *)realloc( conn->out, 2*conn->outsize + SERVERLINE );
+		if ( grown == NULL )
+			return 0;
+		conn->out = grown;
+		conn->outsize = 2*conn->outsize + SERVERLINE;
+	}
+	memcpy( conn->out + conn->outlen, reply, (size_t)len );
+	conn->outlen += (size_t)len;
+	
+	return 1;
+}
+
+
+
+/*---ServerWorker:	Worker thread of server mode, takes a batch of up to SERVERBATCH requests from the front of the queue (waiting while it is empty), solves them with SudokuCacheSolve without holding the lock, writes the reply of each one, then marks the whole batch done with one lock and wakes the main thread through the wake-up pipe.  Exits once the server stops.  Reply, one line:  the solution as 81 digits, or unsolvable, invalid (a value repeated in a row, column or region) or aborted (a budget ran out), followed with stats by a space and the counters of the search as JSON---*/
+void *ServerWorker( void *arg )
+{
+	/*---Define variables in function ServerWorker---*/
+	ServerState *server = (ServerState *)arg;					//State shared with the main thread
+	ServerRequest *batch[SERVERBATCH];						//The requests taken
+	SudokuStats stats;								//Counters of the search of a request with stats
+	int num, ind, cell, status, len;						//Number of requests taken, generic use index (ind) and cell (cell), status returned by SudokuCacheSolve, and length of the reply
+	
+	
+	
+	for ( ;; )
+	{
+		pthread_mutex_lock( &server->lock );
+		while ( !server->stop && server->queuefirst == NULL )
+			pthread_cond_wait( &server->ready, &server->lock );
+		if ( server->stop )
+		{
+			pthread_mutex_unlock( &server->lock );
+			break;
+		}
+		for ( num=0; num<SERVERBATCH && server->queuefirst != NULL; num++ )
+		{
+			batch[num] = server->queuefirst;
+			server->queuefirst = server->queuefirst->queuenext;
+		}
+		if ( server->queuefirst == NULL )
+			server->queuelast = NULL;
+		server->numbatches++;
+		server->numsolved += num;
+		pthread_mutex_unlock( &server->lock );
+		
+		for ( ind=0; ind<num; ind++ )
+		{
+			status = SudokuCacheSolve( server->cache, batch[ind]->board.cell, batch[ind]->board.cell, server->options, batch[ind]->stats ? &stats : NULL );
+			if ( status == SUDOKUOK )
+			{
+				for ( cell=0; cell<81; cell++ )
+					batch[ind]->reply[cell] = (char)( '0' + batch[ind]->board.cell[cell] );
+				len = 81;
+			}
+			else
+				len = sprintf( batch[ind]->reply, "%s", status == SUDOKUUNSOLVABLE ? "unsolvable" : status == SUDOKUABORTED ? "aborted" : "invalid" );
+			if ( batch[ind]->stats )
+				len += sprintf( batch[ind]->reply + len, " {\"nodes\":%ld,\"backtracks\":%ld,\"max_depth\":%d,\"propagations\":%ld,\"eliminations\":%ld,\"micros\":%ld}",
+					stats.nodes, stats.backtracks, stats.maxdepth, stats.propagations, stats.eliminations, (long)( stats.seconds*1e6 + 0.5 ) );
+			batch[ind]->reply[len++] = '\n';
+			batch[ind]->replylen = len;
+		}
+		
+		pthread_mutex_lock( &server->lock );
+		for ( ind=0; ind<num; ind++ )
+			batch[ind]->done = 1;
+		pthread_mutex_unlock( &server->lock );
+		write( server->wakefd[1], "", 1 );					//If the pipe is full, the main thread wakes up anyway
+	}
+	
+	return NULL;
+}
+
+
+
+/*---StopServer:	Signal handler of SIGINT and SIGTERM in server mode, sets serverstop and wakes the main thread from poll (a signal arriving just before poll would not interrupt it), so the main loop shuts the server down---*/
+void StopServer( int sig )
+{
+	(void)sig;
+	serverstop = 1;
+	if ( serverwakefd >= 0 )
+		write( serverwakefd, "", 1 );
+}
+
+
+
+#else
+
+
+
+/*---ServePuzzles:	Server mode needs POSIX sockets and poll, not available on Windows.  Returns 1---*/
+int ServePuzzles( const char *socketname, int port, int numthreads, const SudokuOptions *options, SudokuCache *cache )
+{
+	fprintf( stderr, "ERROR - server mode is not available on Windows\n" );
+	return 1;
+}
+#endif
+
+
+
+/*---Grade:	Grade mode, argc and argv are the command line arguments after -grade:
+	[-o output file] [-maxnodes nodes] [-maxseconds seconds] [-maxmemory bytes] [input file, or - for standard input]
+Reads puzzles one after another from the input with ReadPuzzle (the formats of batch mode), grades each one with library function SudokuGrade, and writes its grade as one JSON line with WriteGrade to the output file (standard output by default), in input order.  The budgets apply to the search of puzzles the techniques of the grader cannot finish.  At the end, the number of puzzles graded per second and the number of puzzles whose hardest technique is each technique, with their mean rating, are printed to standard error.  Returns 0 if every puzzle was read and solved, 1 otherwise---*/
+int Grade( int argc, char *argv[] )
+{
+	/*---Define variables in function Grade---*/
+	PuzzleInput in;									//The input file
+	PuzzleOutput out;								//The output file
+	const char *inname = NULL, *outname = NULL;					//Names of input and output files, NULL for standard input and output
+	SudokuOptions options = { SUDOKUENGINEPROPAGATE, SUDOKUKERNELAUTO, 0, 0.0, 0, NULL };	//Budgets of the search of a puzzle the techniques cannot finish
+	SudokuGrading grade;								//Grade of the puzzle
+	Board board;									//The puzzle grid, reused for every puzzle
+	long numgraded = 0, numsearch = 0, numunsolvable = 0, numaborted = 0, numbad = 0;	//Number of puzzles graded, needing search, with no solution (or invalid), aborted by the budgets, and with wrong format
+	long numhardest[SUDOKUTECHNIQUES];						//Number of puzzles whose hardest technique is each technique
+	double sumrating[SUDOKUTECHNIQUES];						//Sum of the ratings of those puzzles
+	int ind, status;								//Generic use index (ind), and return value of ReadPuzzle, then of SudokuGrade
+	double start, elapsed;								//Wall clock time at start of grading, and time taken
+	
+	
+	
+	for ( ind=0; ind<argc; ind++ )
+	{
+		if ( strcmp( argv[ind], "-o" ) == 0 && ind+1 < argc )
+			outname = argv[++ind];
+		else if ( strcmp( argv[ind], "-maxnodes" ) == 0 && ind+1 < argc )
+			options.maxnodes = atol( argv[++ind] );
+		else if ( strcmp( argv[ind], "-maxseconds" ) == 0 && ind+1 < argc )
+			options.maxseconds = atof( argv[++ind] );
+		else if ( strcmp( argv[ind], "-maxmemory" ) == 0 && ind+1 < argc )
+			options.maxmemory = atol( argv[++ind] );
+		else if ( argv[ind][0] == '-' && argv[ind][1] != '\0' )
+		{
+			fprintf( stderr, "ERROR - unknown option %s of -grade\n", argv[ind] );
+			return 1;
+		}
+		else if ( strcmp( argv[ind], "-" ) != 0 )
+			inname = argv[ind];
+	}
+	if ( !OpenInput( inname, &in ) )
+	{
+		fprintf( stderr, "ERROR - unable to open input file %s\n", inname );
+		return 1;
+	}
+	if ( !OpenOutput( outname, 0, &out ) )
+	{
+		fprintf( stderr, "ERROR - unable to open output file %s\n", outname != NULL ? outname : "(standard output)" );
+		CloseInput( &in );
+		return 1;
+	}
+	
+	
+	
+	memset( numhardest, 0, sizeof(numhardest) );
+	memset( sumrating, 0, sizeof(sumrating) );
+	start = GetWallTime();
+	while ( (status = ReadPuzzle( &in, &board )) != 0 )
+	{
+		if ( status < 0 )
+		{
+			fprintf( stderr, "ERROR - wrong puzzle format ending at line %ld of input, puzzle skipped\n", in.lineno );
+			numbad++;
+			continue;
+		}
 		
-		
-		/*---Adding dead end solution to list of dead end solutions in deadarr---*/
-		for ( ind=0; ind<=indplay; ind++ )
-			deadarr[(*badrowsnum)-1][ind] = grid[rowplay[ind]][colplay[ind]];
+		status = SudokuGrade( board.cell, NULL, &options, &grade );
+		numgraded++;
+		numsearch += ( status == SUDOKUOK && grade.technique == SUDOKUTECHSEARCH );
+		numunsolvable += ( status == SUDOKUUNSOLVABLE || status == SUDOKUINVALID );
+		numaborted += ( status == SUDOKUABORTED );
+		if ( status == SUDOKUOK )
+		{
+			numhardest[grade.technique]++;
+			sumrating[grade.technique] += grade.rating;
+		}
+		WriteGrade( &out, numgraded, &board, status, &grade );
+	}
+	FlushOutput( &out );
+	elapsed = GetWallTime() - start;
+	
+	fprintf( stderr, "Graded %ld puzzles (%ld needing search, %ld with no solution, %ld aborted, %ld with wrong format) in %.3f sec., %.0f puzzles/sec.\n", numgraded, numsearch, numunsolvable, numaborted, numbad, elapsed, elapsed > 0 ? numgraded/elapsed : 0.0 );
+	fprintf( stderr, "\t%-18s\tpuzzles\tmean rating\n", "hardest technique" );
+	for ( ind=0; ind<SUDOKUTECHNIQUES; ind++ )
+		if ( numhardest[ind] > 0 )
+			fprintf( stderr, "\t%-18s\t%ld\t%.2f\n", technames[ind], numhardest[ind], sumrating[ind]/numhardest[ind] );
+	
+	CloseInput( &in );
+	if ( !CloseOutput( &out ) )
+	{
+		fprintf( stderr, "ERROR - unable to write all grades to output file %s\n", outname != NULL ? outname : "(standard output)" );
+		return 1;
+	}
+	
+	return ( numunsolvable || numaborted || numbad ) ? 1 : 0;
+}
+
+
+
+/*---WriteGrade:	Formats the grade of puzzle number puzzle of grade mode into the buffer of the output, as one JSON line:  the puzzle as 81 digits, the result (solved, unsolvable, invalid or aborted, from the status returned by SudokuGrade), the hardest technique and the rating (null and no rating unless the puzzle was solved), the deductions made (steps), the longest chain, the empty cells left for the search and its nodes and deepest level, and the deductions made by each technique, e.g. {"puzzle":1,"grid":"0030...","result":"solved","technique":"x_wing","rating":4.2,"steps":61,"longest_chain":0,"empty":0,"search_nodes":0,"search_depth":0,"uses":{"hidden_single":48,...}}---*/
+void WriteGrade( PuzzleOutput *out, long puzzle, const Board *board, int status, const SudokuGrading *grade )
+{
+	/*---Define variables in function WriteGrade---*/
+	char *dst;									//Where the grade is formatted in the buffer
+	int ind;									//Generic use index in loops
+	const char *result;								//Result of the grading
+	
+	
+	
+	if ( out->len + 1024 > OUTPUTBUFFER )
+		FlushOutput( out );
+	result = status == SUDOKUOK ? "solved" : status == SUDOKUINVALID ? "invalid" : status == SUDOKUABORTED ? "aborted" : "unsolvable";
+	
+	dst = out->buffer + out->len;
+	dst += sprintf( dst, "{\"puzzle\":%ld,\"grid\":\"", puzzle );
+	for ( ind=0; ind<81; ind++ )
+		*dst++ = (char)( '0' + board->cell[ind] );
+	if ( status == SUDOKUOK )
+		dst += sprintf( dst, "\",\"result\":\"%s\",\"technique\":\"%s\",\"rating\":%.1f", result, technames[grade->technique], grade->rating );
+	else										//Not graded to the end, no hardest technique or rating
+		dst += sprintf( dst, "\",\"result\":\"%s\",\"technique\":null", result );
+	dst += sprintf( dst, ",\"steps\":%d,\"longest_chain\":%d,\"empty\":%d,\"search_nodes\":%ld,\"search_depth\":%d,\"uses\":{",
+		grade->steps, grade->longestchain, grade->empty, grade->searchnodes, grade->searchdepth );
+	for ( ind=SUDOKUTECHHIDDENSINGLE; ind<SUDOKUTECHNIQUES; ind++ )
+		dst += sprintf( dst, "%s\"%s\":%d", ind > SUDOKUTECHHIDDENSINGLE ? "," : "", technames[ind], grade->uses[ind] );
+	dst += sprintf( dst, "}}\n" );
+	out->len = (size_t)( dst - out->buffer );
+}
+
+
+
+/*---Benchmark:	Benchmark mode, argc and argv are the command line arguments after -bench:
+	[-o results file] [-runs number of timed runs] [-warmup number of untimed runs] [-puzzles number of puzzles generated of each kind] [-seed number] [puzzle files]
+The corpora timed are the puzzle files given (by default the files of folder puzzles), then BENCHKINDS corpora generated with GenerateCorpus from the seed, so the same seed gives the same puzzles on every machine and every commit.  Each corpus is solved by every engine and kernel the processor supports (function BenchCorpus), one thread, and each result is written as one JSON line to the results file (standard output by default), and as a table to standard error.  Returns 0 if every puzzle was solved, 1 otherwise---*/
+#define BENCHMAXFILES 64
+#define BENCHKINDS 4
+int Benchmark( int argc, char *argv[] )
+{
+	/*---Define variables in function Benchmark---*/
+	Corpus corpora[BENCHMAXFILES + BENCHKINDS];					//The corpora timed, the files first
+	const char *files[BENCHMAXFILES];						//Names of the puzzle files
+	static const char *defaultfiles[] = { "puzzles/input.csv", "puzzles/input_web_easy.csv", "puzzles/input_web_med.csv", "puzzles/input_web_hard.csv", "puzzles/input_web_hardpp.csv" };	//Puzzle files timed if none are given
+	static const SudokuOptions configs[] = { { SUDOKUENGINEPROPAGATE, SUDOKUKERNELSCALAR }, { SUDOKUENGINEPROPAGATE, SUDOKUKERNELSSE42 }, { SUDOKUENGINEPROPAGATE, SUDOKUKERNELAVX2 }, { SUDOKUENGINEDLX, SUDOKUKERNELAUTO } };	//Engine and kernels of each configuration timed (the kernels do not matter to the DLX engine)
+	static const char *confignames[][2] = { { "propagate", "scalar" }, { "propagate", "sse42" }, { "propagate", "avx2" }, { "dlx", NULL } };	//Names of the engine and kernels of each configuration, for the results
+	int numfiles = 0, numcorpora = 0, ind, config;					//Number of puzzle files and of corpora, generic use index (ind), and configuration being timed (config)
+	int runs = 5, warmup = 1;							//Number of timed runs and of untimed (warm-up) runs of each corpus
+	long numgenerated = 1000, unsolved = 0;						//Number of puzzles generated of each kind, and number of puzzles not solved in all configurations
+	unsigned long long seed = 1;							//Seed of the generated corpora
+	const char *outname = NULL;							//Name of results file, NULL for standard output
+	FILE *results = stdout;								//Results file
+	
+	
+	
+	for ( ind=0; ind<argc; ind++ )
+	{
+		if ( strcmp( argv[ind], "-o" ) == 0 && ind+1 < argc )
+			outname = argv[++ind];
+		else if ( strcmp( argv[ind], "-runs" ) == 0 && ind+1 < argc )
+			runs = atoi( argv[++ind] );
+		else if ( strcmp( argv[ind], "-warmup" ) == 0 && ind+1 < argc )
+			warmup = atoi( argv[++ind] );
+		else if ( strcmp( argv[ind], "-puzzles" ) == 0 && ind+1 < argc )
+			numgenerated = atol( argv[++ind] );
+		else if ( strcmp( argv[ind], "-seed" ) == 0 && ind+1 < argc )
+			seed = strtoull( argv[++ind], NULL, 10 );
+		else if ( numfiles < BENCHMAXFILES )
+			files[numfiles++] = argv[ind];
+		else
+		{
+			fprintf( stderr, "ERROR - at most %d puzzle files can be timed\n", BENCHMAXFILES );
+			return 1;
+		}
+	}
+	if ( runs < 1 || warmup < 0 || numgenerated < 0 )
+	{
+		fprintf( stderr, "ERROR - -runs must be at least 1, -warmup and -puzzles at least 0\n" );
+		return 1;
+	}
+	if ( numfiles == 0 )
+	{
+		for ( ind=0; ind<(int)(sizeof(defaultfiles)/sizeof(defaultfiles[0])); ind++ )
+			files[numfiles++] = defaultfiles[ind];
+	}
+	
+	
+	
+	/*---Read the puzzle files and generate the other corpora, before any timing---*/
+	for ( ind=0; ind<numfiles; ind++ )
+	{
+		if ( !LoadCorpus( files[ind], &corpora[numcorpora] ) )
+		{
+			fprintf( stderr, "ERROR - no puzzles read from file %s\n", files[ind] );
+			return 1;
+		}
+		numcorpora++;
+	}
+	for ( ind=0; ind<BENCHKINDS && numgenerated > 0; ind++ )
+		GenerateCorpus( ind, numgenerated, seed, &corpora[numcorpora++] );
+	
+	if ( outname != NULL && (results = fopen( outname, "w" )) == NULL )
+	{
+		fprintf( stderr, "ERROR - unable to open results file %s\n", outname );
+		return 1;
+	}
+	
+	
+	
+	/*---Time every corpus in every configuration---*/
+	fprintf( stderr, "%-28s %8s %-10s %-7s %12s %12s %14s\n", "corpus", "puzzles", "engine", "kernel", "median usec", "p99 usec", "puzzles/sec" );
+	for ( ind=0; ind<numcorpora; ind++ )
+	{
+		for ( config=0; config<(int)(sizeof(configs)/sizeof(configs[0])); config++ )
+		{
+			if ( SudokuCheckOptions( &configs[config] ) != SUDOKUOK )		//Instruction set not supported by this processor
+				continue;
+			unsolved += BenchCorpus( &corpora[ind], &configs[config], confignames[config][0], confignames[config][1], runs, warmup, seed, results );
+		}
+		free( corpora[ind].puzzles );
+	}
+	
+	if ( outname != NULL && fclose( results ) != 0 )
+	{
+		fprintf( stderr, "ERROR - unable to write all results to results file %s\n", outname );
+		return 1;
+	}
+	
+	return unsolved ? 1 : 0;
+}
+
+
+
+/*---LoadCorpus:	Reads all puzzles of file filename (in any format of batch mode, see ReadPuzzle) into corpus, named after the file, reporting and skipping puzzles with wrong format.  Returns 1 if at least one puzzle was read, 0 otherwise---*/
+int LoadCorpus( const char *filename, Corpus *corpus )
+{
+	/*---Define variables in function LoadCorpus---*/
+	PuzzleInput in;									//The puzzle file
+	Board *grown;									//The puzzles, moved to a larger block
+	long maxpuzzles = 16;								//Number of puzzles corpus->puzzles has room for
+	int status;									//Return value of ReadPuzzle
+	char *c;									//Generic use character of the name
+	
+	
+	
+	if ( !OpenInput( filename, &in ) )
+		return 0;
+	
+	snprintf( corpus->name, sizeof(corpus->name), "%s", filename );
+	for ( c=corpus->name; *c; c++ )							//The name is written in JSON strings as it is
+	{
+		if ( *c == '"' || *c == '\\' || (unsigned char)*c < ' ' )
+			*c = '_';
+	}
+	
+	corpus->numpuzzles = 0;
+	corpus->puzzles = (Board *)malloc( maxpuzzles*sizeof(Board) );
+	while ( corpus->puzzles != NULL && (status = ReadPuzzle( &in, &corpus->puzzles[corpus->numpuzzles] )) != 0 )
+	{
+		if ( status < 0 )
+		{
+			fprintf( stderr, "ERROR - wrong puzzle format ending at line %ld of %s, puzzle skipped\n", in.lineno, filename );
+			continue;
+		}
+		if ( ++corpus->numpuzzles == maxpuzzles )
+		{
+			maxpuzzles *= 2;
+			grown = (Board *)realloc( corpus->puzzles, maxpuzzles*sizeof(Board) );
+			if ( grown == NULL )
+				free( corpus->puzzles );
+			corpus->puzzles = grown;
+		}
+	}
+	CloseInput( &in );
+	
+	if ( corpus->puzzles == NULL )
+	{
+		fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for the benchmark, try a smaller puzzle file.  Now exiting\n\n\n");
+		exit(1);
+	}
+	if ( corpus->numpuzzles == 0 )
+	{
+		free( corpus->puzzles );
+		return 0;
+	}
+	
+	return 1;
+}
+
+
+
+/*---GenerateCorpus:	Generates numpuzzles puzzles of one kind into corpus, from the seed, so the same seed always gives the same puzzles:  0) easy, a random solved grid (RandomGrid) with values removed down to 36 clues (RemoveClues), 1) minimal, values removed until none can be removed (typically 22 to 26 clues), 2) 17clue, puzzles with 17 clues (the fewest possible for one solution), and 3) adversarial, puzzles known to be hard for backtracking solvers (e.g. the one built against brute force, AI Escargot, Platinum Blonde, Golden Nugget).  The 17-clue and adversarial corpora start with their listed puzzles as they are, followed by random equivalent puzzles (TransformPuzzle).  Every puzzle has exactly one solution---*/
+void GenerateCorpus( int kind, long numpuzzles, unsigned long long seed, Corpus *corpus )
+{
+	/*---Define variables in function GenerateCorpus---*/
+	static const char *names[BENCHKINDS] = { "easy", "minimal", "17clue", "adversarial" };	//Name of each kind of corpus
+	static const char *seventeen[] =						//Puzzles with 17 clues
+	{
+		"000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+		"000000010400000000020000000000050604008000300001090000300400200050100000000807000",
+		"000000012000035000000600070700000300000400800100000000000120000080000040050000600",
+		"000000012003600000000007000410020000000500300700000600280000040000300500000000000",
+		"000000012008030000000000040120500000000004700060000000507000300000620000000100000"
+	};
+	static const char *adversarial[] =						//Puzzles hard for backtracking solvers
+	{
+		"000000000000003085001020000000507000004000100090000000500000073002010000000040009",
+		"000000012000000003002300400001800005060070800000009000008500000900040500470006000",
+		"000000039000001005003050800008090006070002000100400000009080050020000600400700000",
+		"100007090030020008009600500005300900010080002600004000300000010040000007007000300",
+		"800000000003600000070090200050007000000045700000100030001000068008500010090000400"
+	};
+	unsigned long long rng = seed*BENCHKINDS + (unsigned long long)kind;		//State of the pseudo-random sequence, different for each kind
+	long ind;									//Index of the puzzle being generated
+	
+	
+	
+	snprintf( corpus->name, sizeof(corpus->name), "%s", names[kind] );
+	corpus->numpuzzles = numpuzzles;
+	corpus->puzzles = (Board *)malloc( numpuzzles*sizeof(Board) );
+	if ( corpus->puzzles == NULL )
+	{
+		fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for the benchmark, try fewer puzzles.  Now exiting\n\n\n");
+		exit(1);
+	}
+	
+	for ( ind=0; ind<numpuzzles; ind++ )
+	{
+		if ( kind < 2 )
+		{
+			RandomGrid( &corpus->puzzles[ind], &rng );
+			RemoveClues( &corpus->puzzles[ind], kind == 0 ? 36 : 0, &rng );
+		}
+		else
+		{
+			ParseLine81( kind == 2 ? seventeen[ind % 5] : adversarial[ind % 5], corpus->puzzles[ind].cell );
+			if ( ind >= 5 )
+				TransformPuzzle( &corpus->puzzles[ind], &rng );
+		}
+	}
+}
+
 
-		grid[rowplay[indplay]][colplay[indplay]] = 0;				//Setting value of current cell back to zero, before recursion is called, so doesn't mess up assignment of numbers to previous playable cells
+
+/*---BenchCorpus:	Solves every puzzle of the corpus with SudokuSolve, with the engine and kernels of options (named enginename and kernelname for the results, along with the seed the corpora were generated from), warmup times without timing, then runs times timing each puzzle and each run.  Writes one JSON line to results with the median, 99th percentile, mean and maximum time of one puzzle (over all timed runs), and the puzzles solved per second of the median run, and the same as one line of a table to standard error.  Returns the number of puzzles not solved---*/
+long BenchCorpus( const Corpus *corpus, const SudokuOptions *options, const char *enginename, const char *kernelname, int runs, int warmup, unsigned long long seed, FILE *results )
+{
+	/*---Define variables in function BenchCorpus---*/
+	long numtimed = corpus->numpuzzles*runs;					//Number of puzzles timed
+	double *latency = (double *)malloc( numtimed*sizeof(double) );			//Time taken by each puzzle of each timed run, sorted at the end
+	double *runtime = (double *)malloc( runs*sizeof(double) );			//Time taken by each timed run, sorted at the end
+	double start, runstart, total = 0.0;						//Wall clock time at start of a puzzle and of a run, and sum of the times of all puzzles (total)
+	Board board;									//The puzzle being solved, a copy so the corpus stays unsolved
+	long ind, unsolved = 0;								//Index of puzzle (ind), and number of puzzles not solved
+	int run, solved;								//Run, negative for the warm-up runs (run), and 1 if the puzzle was solved (solved)
+	
+	
+	
+	if ( latency == NULL || runtime == NULL )
+	{
+		fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for the benchmark, try fewer puzzles or runs.  Now exiting\n\n\n");
+		exit(1);
+	}
+	
+	for ( run=-warmup; run<runs; run++ )
+	{
+		runstart = GetWallTime();
+		for ( ind=0; ind<corpus->numpuzzles; ind++ )
+		{
+			board = corpus->puzzles[ind];
+			start = GetWallTime();
+			solved = ( SudokuSolve( board.cell, board.cell, options, NULL ) == SUDOKUOK );
+			if ( run >= 0 )
+				latency[run*corpus->numpuzzles + ind] = GetWallTime() - start;
+			if ( run == 0 )
+				unsolved += !solved;
+		}
+		if ( run >= 0 )
+			runtime[run] = GetWallTime() - runstart;
+	}
+	
+	for ( ind=0; ind<numtimed; ind++ )
+		total += latency[ind];
+	qsort( latency, numtimed, sizeof(double), CompareDoubles );
+	qsort( runtime, runs, sizeof(double), CompareDoubles );
+	
+	fprintf( results, "{\"corpus\":\"%s\",\"puzzles\":%ld,\"engine\":\"%s\",\"kernel\":\"%s\",\"seed\":%llu,\"warmup\":%d,\"runs\":%d,\"median_us\":%.3f,\"p99_us\":%.3f,\"mean_us\":%.3f,\"max_us\":%.3f,\"puzzles_per_sec\":%.0f,\"unsolved\":%ld}\n",
+		corpus->name, corpus->numpuzzles, enginename, kernelname != NULL ? kernelname : "none", seed, warmup, runs,
+		latency[(numtimed-1)/2]*1e6, latency[(long)( (numtimed-1)*0.99 )]*1e6, total/numtimed*1e6, latency[numtimed-1]*1e6,
+		runtime[(runs-1)/2] > 0 ? corpus->numpuzzles/runtime[(runs-1)/2] : 0.0, unsolved );
+	fprintf( stderr, "%-28s %8ld %-10s %-7s %12.3f %12.3f %14.0f%s\n", corpus->name, corpus->numpuzzles, enginename, kernelname != NULL ? kernelname : "none",
+		latency[(numtimed-1)/2]*1e6, latency[(long)( (numtimed-1)*0.99 )]*1e6, runtime[(runs-1)/2] > 0 ? corpus->numpuzzles/runtime[(runs-1)/2] : 0.0, unsolved ? "  (not all solved)" : "" );
+	
+	free( latency );
+	free( runtime );
+	
+	return unsolved;
+}
 
 
 
-		/*---Recursive call on AnalyzeCell for playable cell (indplay-1)---*/
-		deadarr = AnalyzeCell(grid,rowplay,colplay,indplay-1, numcols, numrows, deadarr, badrowsnum, numcells, badrowsmem);
-	}	
+/*---Generate:	Generate mode, argc and argv are the command line arguments after -generate:
+	[-o output file] [-compact] [-puzzles number of puzzles] [-clues number of clues] [-difficulty easy, medium or hard] [-threads number of threads, 0 for one per processor] [-seed number]
+Generates puzzles with exactly one solution (function GeneratePuzzle), with the number of clues given (by default as few as possible, a minimal puzzle) and of the difficulty given (by default any), and writes them to the output file (standard output by default) with OutputPuzzle, in CSV format followed by a blank line or with -compact as one line of 81 characters, so batch mode reads them back.  The puzzles are generated in chunks of GENCHUNK by numthreads worker threads (function GenerateWorker) and written in order.  Each puzzle only depends on the seed and its place in the output, so the same seed gives the same puzzles on any number of threads.  Returns 0 if all puzzles were generated and written, 1 otherwise---*/
+#define GENCHUNK 4096
+int Generate( int argc, char *argv[] )
+{
+	/*---Define variables in function Generate---*/
+	static const char *difficultynames[] = { "any", "easy", "medium", "hard" };	//Names of the difficulties for -difficulty, in the order of the GEN codes
+	GenerateChunk chunk;								//The chunk of puzzles being generated
+	pthread_t *threads;								//The worker threads
+	PuzzleOutput out;								//The output file
+	const char *outname = NULL;							//Name of output file, NULL for standard output
+	int compact = 0, numthreads = 1, ind, th;					//1 to write each puzzle as one line (-compact), number of worker threads, generic use index (ind), and index of worker thread (th)
+	long numpuzzles = 1000, numdone = 0, numtries = 0, puz;				//Number of puzzles to generate, number generated so far, candidates generated for them, and index of puzzle in the chunk (puz)
+	SudokuStats stats;								//Counters of the search of an empty grid, to check that the library counts searches (for -difficulty)
+	unsigned char grid[81];								//The empty grid
+	double start = GetWallTime(), elapsed;						//Wall clock time at start, and time taken
+	
+	
+	
+	chunk.clues = 0;
+	chunk.difficulty = GENANY;
+	chunk.seed = 1;
+	for ( ind=0; ind<argc; ind++ )
+	{
+		if ( strcmp( argv[ind], "-o" ) == 0 && ind+1 < argc )
+			outname = argv[++ind];
+		else if ( strcmp( argv[ind], "-compact" ) == 0 )
+			compact = 1;
+		else if ( strcmp( argv[ind], "-puzzles" ) == 0 && ind+1 < argc )
+			numpuzzles = atol( argv[++ind] );
+		else if ( strcmp( argv[ind], "-clues" ) == 0 && ind+1 < argc )
+			chunk.clues = atoi( argv[++ind] );
+		else if ( strcmp( argv[ind], "-seed" ) == 0 && ind+1 < argc )
+			chunk.seed = strtoull( argv[++ind], NULL, 10 );
+		else if ( strcmp( argv[ind], "-threads" ) == 0 && ind+1 < argc )
+		{
+			numthreads = atoi( argv[++ind] );
+			if ( numthreads <= 0 )
+				numthreads = (int)sysconf( _SC_NPROCESSORS_ONLN );
+		}
+		else if ( strcmp( argv[ind], "-difficulty" ) == 0 && ind+1 < argc )
+		{
+			ind++;
+			for ( chunk.difficulty=GENHARD; chunk.difficulty>GENANY; chunk.difficulty-- )
+				if ( strcmp( argv[ind], difficultynames[chunk.difficulty] ) == 0 )
+					break;
+			if ( chunk.difficulty == GENANY && strcmp( argv[ind], "any" ) != 0 )
+			{
+				fprintf( stderr, "ERROR - unknown difficulty %s\n", argv[ind] );
+				return 1;
+			}
+		}
+		else
+		{
+			fprintf( stderr, "ERROR - unknown option %s of -generate\n", argv[ind] );
+			return 1;
+		}
+	}
+	if ( numpuzzles < 0 || (chunk.clues != 0 && (chunk.clues < 17 || chunk.clues > 81)) )
+	{
+		fprintf( stderr, "ERROR - -puzzles must be at least 0, and -clues 17 to 81 (0 for as few as possible)\n" );
+		return 1;
+	}
+	memset( grid, 0, sizeof(grid) );
+	if ( chunk.difficulty != GENANY && (SudokuSolve( grid, grid, NULL, &stats ) != SUDOKUOK || stats.nodes == 0) )
+	{
+		fprintf( stderr, "ERROR - -difficulty needs the search counters, and the solver library was compiled with -DNOSTATS\n" );
+		return 1;
+	}
+	if ( !OpenOutput( outname, compact, &out ) )
+	{
+		fprintf( stderr, "ERROR - unable to open output file %s\n", outname != NULL ? outname : "(standard output)" );
+		return 1;
+	}
 	
-	grid[rowplay[indplay]][colplay[indplay]] = val;
+	
+	
+	/*---Allocate memory for the chunk and the worker threads, and check for memory allocation errors---*/
+	chunk.puzzles = (Board *)malloc( GENCHUNK*sizeof(Board) );
+	chunk.tries = (long *)malloc( GENCHUNK*sizeof(long) );
+	threads = (pthread_t *)malloc( numthreads*sizeof(pthread_t) );
+	if ( chunk.puzzles == NULL || chunk.tries == NULL || threads == NULL )
+	{
+		fprintf(stderr,"\n\n\nERROR - unable to allocate required memory for generate mode, try fewer threads.  Now exiting\n\n\n");
+		exit(1);
+	}
+	pthread_mutex_init( &chunk.queue.lock, NULL );
+	
+	
+	
+	/*---Generate the puzzles chunk by chunk, each chunk by all worker threads, and write them in order---*/
+	while ( numdone < numpuzzles )
+	{
+		chunk.first = numdone;
+		chunk.queue.next = 0;
+		chunk.queue.end = numpuzzles - numdone < GENCHUNK ? numpuzzles - numdone : GENCHUNK;
+		chunk.numpuzzles = chunk.queue.end;
+		for ( th=0; th<numthreads; th++ )
+		{
+			if ( pthread_create( &threads[th], NULL, GenerateWorker, &chunk ) != 0 )
+			{
+				fprintf(stderr,"\n\n\nERROR - unable to start worker thread, try fewer threads.  Now exiting\n\n\n");
+				exit(1);
+			}
+		}
+		for ( th=0; th<numthreads; th++ )
+			pthread_join( threads[th], NULL );
 		
-	return deadarr;									//Must return pointer to deadarr in case memory is reallocated
+		for ( puz=0; puz<chunk.numpuzzles; puz++ )
+		{
+			if ( chunk.tries[puz] == 0 )
+				break;
+			OutputPuzzle( &out, &chunk.puzzles[puz] );
+			numtries += chunk.tries[puz];
+			numdone++;
+		}
+		if ( puz < chunk.numpuzzles )
+		{
+			fprintf( stderr, "ERROR - no puzzle with %d clues and difficulty %s found in %d candidates, try more clues or another difficulty\n", chunk.clues, difficultynames[chunk.difficulty], GENMAXTRIES );
+			break;
+		}
+	}
+	
+	FlushOutput( &out );
+	elapsed = GetWallTime() - start;
+	fprintf( stderr, "Generated %ld puzzles (from %ld candidates) in %.3f sec. on %d threads, %.0f puzzles/sec.\n", numdone, numtries, elapsed, numthreads, elapsed > 0 ? numdone/elapsed : 0.0 );
+	
+	
+	
+	/*---Release memory---*/
+	pthread_mutex_destroy( &chunk.queue.lock );
+	free( chunk.puzzles );
+	free( chunk.tries );
+	free( threads );
+	
+	if ( !CloseOutput( &out ) )
+	{
+		fprintf( stderr, "ERROR - unable to write all puzzles to output file %s\n", outname != NULL ? outname : "(standard output)" );
+		return 1;
+	}
+	
+	return numdone < numpuzzles ? 1 : 0;
+}
+
+
 
+/*---GenerateWorker:	Worker thread of Generate, takes the puzzles of the chunk one at a time from its queue (shared by all worker threads, since the time a puzzle takes varies a lot) and generates them with GeneratePuzzle, until the queue is empty---*/
+void *GenerateWorker( void *arg )
+{
+	/*---Define variables in function GenerateWorker---*/
+	GenerateChunk *chunk = (GenerateChunk *)arg;					//The chunk of puzzles being generated
+	long first, end, ind;								//Range of puzzles taken (first to end), and generic use index (ind)
+	
+	
+	
+	while ( (first = TakeWork( &chunk->queue, 1, &end )) >= 0 )
+		for ( ind=first; ind<end; ind++ )
+			chunk->tries[ind] = GeneratePuzzle( &chunk->puzzles[ind], chunk->first + ind, chunk->clues, chunk->difficulty, chunk->seed );
+	
+	return NULL;
 }
 
 
 
-/*---RelMem2DArr:	Releases memory reserved for a 2D array---*/
-void RelMem2DArr( int **myarr, int numrows )
+/*---GeneratePuzzle:	Generates puzzle number index of the output into board, from a pseudo-random sequence of its own started from the seed and index (so it depends on nothing else):  a random solved grid (RandomGrid) has its values removed in random order, each removal kept only if the puzzle still has exactly one solution (RemoveClues, with SudokuCount as the uniqueness check), down to clues values, or until no value can be removed if clues is 0.  A candidate left with more than clues values, or whose difficulty (function PuzzleDifficulty) is not difficulty (unless GENANY), is thrown away for a new one, up to GENMAXTRIES candidates.  Returns the number of candidates generated, 0 if none was kept---*/
+long GeneratePuzzle( Board *board, long index, int clues, int difficulty, unsigned long long seed )
 {
-	/*---Define variables in function RelMem2DArr---*/
-	int row;									//Generic use row in 2D array (row)
+	/*---Define variables in function GeneratePuzzle---*/
+	unsigned long long rng = seed + (unsigned long long)index*0xD1B54A32D192ED03ULL;	//State of the pseudo-random sequence of this puzzle (the step is not the one of NextRandom, so the sequences of two puzzles do not overlap)
+	long tries;									//Number of candidates generated
+	int cell, numclues;								//Generic use cell, and number of values left
+	
 	
 	
+	for ( tries=1; tries<=GENMAXTRIES; tries++ )
+	{
+		RandomGrid( board, &rng );
+		RemoveClues( board, clues, &rng );
+		numclues = 0;
+		for ( cell=0; cell<81; cell++ )
+			numclues += ( board->cell[cell] != 0 );
+		if ( clues > 0 && numclues > clues )
+			continue;
+		if ( difficulty != GENANY && PuzzleDifficulty( board ) != difficulty )
+			continue;
+		return tries;
+	}
 	
-	for ( row=0; row<numrows; row++ )
- 		 free( myarr[row] );
-	free(myarr);
+	return 0;
 }
 
 
 
-/*---RelMem1DArr:	Releases memory reserved for a 1D array---*/
-void RelMem1DArr( int *myarr )
+/*---PuzzleDifficulty:	Rates a puzzle with one solution by the search the propagate engine needs for it:  GENEASY if singles and locked candidates solve it with no guessing, GENMEDIUM if it needs guessing but fewer than GENHARDNODES nodes, GENHARD otherwise.  Returns the rating---*/
+int PuzzleDifficulty( const Board *board )
 {
-	free(myarr);
+	/*---Define variables in function PuzzleDifficulty---*/
+	unsigned char solution[81];							//Solution of the puzzle, not used
+	SudokuStats stats;								//Counters of the search of the puzzle
+	
+	
+	
+	SudokuSolve( board->cell, solution, NULL, &stats );
+	if ( stats.maxdepth == 0 )
+		return GENEASY;
+	
+	return stats.nodes < GENHARDNODES ? GENMEDIUM : GENHARD;
 }
 
 
 
-/*---WritePuzzle:	Writes to file SolvedSudokuPuzzle.csv the solved state of the Sudoku puzzle---*/
-void WritePuzzle( int **grid, int numrows, int numcols)
+/*---RandomGrid:	Fills board with a random solved grid:  up to 11 values are placed in random cells (skipping those that break the rules of Sudoku, checked with SudokuValidate), and the rest is filled in by SudokuSolve.  If that has no solution, it starts over---*/
+void RandomGrid( Board *board, unsigned long long *rng )
 {
-	/*---Define variables in function WritePuzzle---*/
-	FILE *fp = fopen( "SolvedSudokuPuzzle.csv", "w" );				//Output file for solved Sudoku puzzle
-	int row, col;									//Generic use row in 2D array (row), and column in 2D array (col)
+	/*---Define variables in function RandomGrid---*/
+	int ind, cell, val;								//Generic use index (ind), cell (cell) and value (val)
 	
 	
 	
-	for ( row=0; row<numrows; row++ )
+	do
 	{
-		for ( col=0; col<numcols; col++ )
+		memset( board, 0, sizeof(*board) );
+		for ( ind=0; ind<11; ind++ )
 		{
-			fputc( grid[row][col]+(int)('0'), fp );
-			if ( col != numcols-1 )
-				fputs( ",", fp );
+			cell = (int)( NextRandom( rng ) % 81 );
+			val = (int)( NextRandom( rng ) % 9 ) + 1;
+			if ( board->cell[cell] != 0 )
+				continue;
+			board->cell[cell] = (unsigned char)val;
+			if ( SudokuValidate( board->cell ) != SUDOKUOK )			//The value is already in the row, column or region of the cell
+				board->cell[cell] = 0;
 		}
-		if ( row != numrows-1 )
-			fputs( "\n", fp );
 	}
+	while ( SudokuSolve( board->cell, board->cell, NULL, NULL ) != SUDOKUOK );
+}
+
+
+
+/*---RemoveClues:	Removes the values of board one at a time, in random order, keeping each value whose removal gives the puzzle more than one solution (checked with SudokuCount), until only minclues values are left or every cell has been tried (the puzzle is then minimal, no value can be removed).  board must have exactly one solution to start with---*/
+void RemoveClues( Board *board, int minclues, unsigned long long *rng )
+{
+	/*---Define variables in function RemoveClues---*/
+	int order[81];									//Order the cells are tried in
+	int ind, cell, val, numclues = 0;						//Generic use index (ind), cell (cell) and value (val), and number of values left (numclues)
+	int count;									//Number of solutions of the puzzle with a value removed, up to 2
 	
-	fclose(fp);
+	
+	
+	for ( cell=0; cell<81; cell++ )
+		numclues += ( board->cell[cell] != 0 );
+	
+	RandomPermutation( order, 81, rng );
+	for ( ind=0; ind<81 && numclues > minclues; ind++ )
+	{
+		cell = order[ind];
+		if ( (val = board->cell[cell]) == 0 )
+			continue;
+		board->cell[cell] = 0;
+		if ( SudokuCount( board->cell, 2, &count, NULL, NULL, NULL ) == SUDOKUOK )
+			numclues--;
+		else
+			board->cell[cell] = (unsigned char)val;
+	}
+}
+
+
+
+/*---TransformPuzzle:	Changes board into a random equivalent puzzle, which has one solution if board has, and needs the same deductions to solve:  the values are relabeled, the 3 bands (groups of 3 rows) are reordered and so are the rows within each band, the same for the stacks (groups of 3 columns) and the columns within each stack, and the grid is transposed half the time---*/
+void TransformPuzzle( Board *board, unsigned long long *rng )
+{
+	/*---Define variables in function TransformPuzzle---*/
+	int relabel[9], bands[3], stacks[3], within[3];					//New label of each value (relabel), and orders of the bands, stacks, and the rows or columns within one of them
+	int rowmap[9], colmap[9];							//Row and column of board each row and column of the new puzzle comes from
+	int row, col, ind, transpose;							//Generic use row (row), column (col) and index (ind), and 1 to transpose
+	Board old = *board;								//The puzzle before the change
+	
+	
+	
+	RandomPermutation( relabel, 9, rng );
+	RandomPermutation( bands, 3, rng );
+	RandomPermutation( stacks, 3, rng );
+	for ( ind=0; ind<3; ind++ )
+	{
+		RandomPermutation( within, 3, rng );
+		for ( row=0; row<3; row++ )
+			rowmap[ind*3 + row] = bands[ind]*3 + within[row];
+		RandomPermutation( within, 3, rng );
+		for ( col=0; col<3; col++ )
+			colmap[ind*3 + col] = stacks[ind]*3 + within[col];
+	}
+	transpose = (int)( NextRandom( rng ) & 1 );
+	
+	for ( row=0; row<9; row++ )
+	{
+		for ( col=0; col<9; col++ )
+		{
+			ind = transpose ? colmap[col]*9 + rowmap[row] : rowmap[row]*9 + colmap[col];
+			board->cell[row*9 + col] = (unsigned char)( old.cell[ind] ? relabel[old.cell[ind]-1] + 1 : 0 );
+		}
+	}
+}
+
+
+
+/*---RandomPermutation:	Fills perm with 0 to n-1 in random order (Fisher-Yates shuffle)---*/
+void RandomPermutation( int *perm, int n, unsigned long long *rng )
+{
+	/*---Define variables in function RandomPermutation---*/
+	int ind, other, swap;								//Generic use index (ind), index to swap with (other), and value being swapped (swap)
+	
+	
+	
+	for ( ind=0; ind<n; ind++ )
+		perm[ind] = ind;
+	for ( ind=n-1; ind>0; ind-- )
+	{
+		other = (int)( NextRandom( rng ) % (unsigned long long)(ind+1) );
+		swap = perm[ind];
+		perm[ind] = perm[other];
+		perm[other] = swap;
+	}
+}
+
+
+
+/*---NextRandom:	Returns the next number of the pseudo-random sequence with state rng (splitmix64), the same sequence on every machine for the same starting state---*/
+unsigned long long NextRandom( unsigned long long *rng )
+{
+	/*---Define variables in function NextRandom---*/
+	unsigned long long z = (*rng += 0x9E3779B97F4A7C15ULL);				//Next state, scrambled into the number returned
+	
+	
+	
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+
+
+/*---CompareDoubles:	Comparison function for qsort, orders doubles from lowest to highest---*/
+int CompareDoubles( const void *a, const void *b )
+{
+	/*---Define variables in function CompareDoubles---*/
+	double x = *(const double *)a, y = *(const double *)b;				//The two values compared
+	
+	
+	
+	return (x > y) - (x < y);
+}
+
+
+
+/*---GetWallTime:	Returns the current wall clock time in seconds---*/
+double GetWallTime( void )
+{
+	/*---Define variables in function GetWallTime---*/
+	struct timespec ts;								//Current time, in seconds and nanoseconds
+	
+	
+	
+	timespec_get( &ts, TIME_UTC );
+	return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
 }
+
+
+